@@ -10,8 +10,21 @@
 #include <cmath> // For std::sqrt and std::pow
 #include <algorithm>
 #include <stdexcept>
+#include <fstream>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 #include "../core/thread_pool.hpp"
+#include "../core/huge_page_allocator.hpp"
+#include "../core/heartbeat.hpp"
+#include "../core/worker_local.hpp"
+#include "kernel_structure.hpp"
 
 /**
  * @file convolution.hpp
@@ -28,6 +41,8 @@
  *   across a range of z-slices.
  * - Multiple filter types are defined (Gaussian blur, Laplacian, Z-axis edge).
  * - Results include timing, noise reduction verification, and edge detection metrics.
+ * - Volumes can be streamed from disk with the pool's asynchronous reads, so each
+ *   slice is filtered as soon as it and its neighbours have arrived.
  *
  * @author dssregi
  * @version 1.0
@@ -67,44 +82,129 @@ constexpr int VOLUME_SIZE = IMG_WIDTH * IMG_HEIGHT * IMG_DEPTH;
 /**
  * @brief Type alias for 3D volume data.
  *
- * Stored as a 1D vector in row-major order: index = z*W*H + y*W + x.
+ * Stored as a 1D vector in row-major order: index = z*W*H + y*W + x. Volumes of
+ * 2 MiB and more are mapped on huge pages (`huge_page_allocator.hpp`), which
+ * keeps the z-neighbour accesses a plane apart within the dTLB's reach.
+ * `Image(n)` holds n zeros and `Image(n, value)` fills them with @p value;
+ * `Image(n, UNINITIALISED_VOXELS)` leaves them unwritten.
+ */
+using Image = std::vector<float, HugePageAllocator<float>>;
+
+/**
+ * @brief Allocator for volumes every voxel of which is written before it is read,
+ *        such as convolution outputs: `Image(n, UNINITIALISED_VOXELS)` skips the
+ *        zero fill.
+ */
+inline constexpr HugePageAllocator<float> UNINITIALISED_VOXELS{default_init};
+
+/**
+ * @brief Structure analysis of the 3x3x3 kernels (`kernel_structure.hpp`).
+ */
+using KernelStructure = BasicKernelStructure<KERNEL_DIM>;
+
+/**
+ * @brief Outputs at least this many times the last-level cache are written with
+ *        non-temporal stores.
+ */
+constexpr size_t STREAMING_STORE_LLC_FACTOR = 4;
+
+/**
+ * @brief Size of the last-level cache, or 32 MiB if the system does not say.
+ */
+inline size_t last_level_cache_bytes() {
+    static const size_t bytes = [] {
+        long llc = 0;
+#ifdef _SC_LEVEL3_CACHE_SIZE
+        llc = ::sysconf(_SC_LEVEL3_CACHE_SIZE);
+        if (llc <= 0) {
+            llc = ::sysconf(_SC_LEVEL2_CACHE_SIZE);
+        }
+#endif
+        return llc > 0 ? static_cast<size_t>(llc) : size_t{32} << 20;
+    }();
+    return bytes;
+}
+
+/**
+ * @brief Whether an output volume of @p bytes should bypass the cache.
+ *
+ * A volume much larger than the last-level cache is evicted before anyone reads
+ * it again, so caching its lines only costs a read-for-ownership per line and
+ * the eviction of input planes the stencil still needs.
  */
-using Image = std::vector<float>; 
+inline bool streaming_stores_pay_off(size_t bytes) {
+#if defined(__SSE2__)
+    return bytes >= STREAMING_STORE_LLC_FACTOR * last_level_cache_bytes();
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief How `execute_convolution` decomposes the volume into pool tasks.
+ */
+enum class ConvolutionSchedule {
+    /**
+     * @brief Submit one task per fixed range of z-slices up front
+     *        (`ConvolutionTask::slice_grain`).
+     */
+    per_slice,
+
+    /**
+     * @brief Run slices serially on the caller and let `heartbeat_for` promote
+     *        ranges of slices to tasks only on heartbeats or idle workers.
+     */
+    heartbeat
+};
 
 /**
  * @brief Command object (Functor) for executing 3D convolution on depth slices.
  *
  * This class encapsulates a convolution task for a range of depth (z-axis) slices.
- * It implements the Command pattern and is designed to be submitted to the thread pool.
+ * It implements the Command pattern and is designed to be submitted to the thread pool,
+ * either wrapped in a callable or directly by reference as an `IntrusiveTask`.
  *
  * @details
  * - Each task processes one or more consecutive z-slices.
- * - For each slice, it iterates over all valid (y, x) positions (excluding borders)
- *   and computes the convolution result using the provided kernel.
- * - Results are written to the output image at the same (z, y, x) position.
- * - An atomic counter is incremented at the end to signal completion.
+ * - The interior (all valid (y, x) positions, excluding borders) is computed by a
+ *   register-blocked microkernel: 2 slices x 2 rows x 2 SIMD vectors of outputs
+ *   per call, sweeping the range two slices at a time, so each input voxel is
+ *   loaded a few times per block instead of 27 times per output.
+ * - Results are written to the output image at the same (z, y, x) position; the
+ *   border voxels of each slice are zeroed by the same task, and the border
+ *   planes by the tasks owning the first and last slices, so the output needs
+ *   no initialisation and the border is cleared in parallel.
+ * - With `stream_output`, interior voxels are written with non-temporal stores
+ *   (`movnti`), which skip the read-for-ownership of each output line.
+ * - A per-worker sharded counter is incremented at the end to signal completion.
  *
  * @note
- * The class stores const references to input, kernel, and the output image.
- * Care must be taken to ensure these remain valid during task execution.
+ * The class stores pointers to the input and output volumes and a reference to
+ * the kernel. Care must be taken to ensure these remain valid during task
+ * execution.
  */
-class ConvolutionTask {
+class ConvolutionTask final : public IntrusiveTask {
 private:
     /**
-     * @brief Const reference to the input 3D volume.
+     * @brief First voxel of the input 3D volume (`VOLUME_SIZE` floats).
      */
-    const Image& input_;
+    const float* input_;
 
     /**
-     * @brief Reference to the output 3D volume where results are written.
+     * @brief First voxel of the output 3D volume where results are written.
      */
-    Image& output_;
+    float* output_;
 
     /**
      * @brief Const reference to the convolution kernel (27 floats for 3x3x3).
      */
     const std::vector<float>& kernel_;
 
+    /**
+     * @brief Zero pattern and symmetry of `kernel_`, selecting the code path.
+     */
+    const KernelStructure structure_;
+
     /**
      * @brief Starting z-coordinate (depth) of the slice range for this task.
      */
@@ -116,11 +216,17 @@ private:
     const int end_slice_;
 
     /**
-     * @brief Atomic counter tracking completed slices (for synchronization).
+     * @brief Sharded counter tracking completed slices (for synchronization).
      *
-     * Incremented by (end_slice_ - start_slice_) when task completes.
+     * Incremented by (end_slice_ - start_slice_) on the executing worker's own
+     * shard when the task completes, so concurrent tasks do not contend.
+     */
+    ShardedCounter& completed_slices_counter_;
+
+    /**
+     * @brief Write interior voxels with non-temporal stores.
      */
-    std::atomic<int>& completed_slices_counter_;
+    const bool stream_output_;
 
     /**
      * @brief Convert 3D coordinates (z, y, x) to 1D index in row-major order.
@@ -135,6 +241,412 @@ private:
         return z * IMG_WIDTH * IMG_HEIGHT + y * IMG_WIDTH + x;
     }
 
+    /**
+     * @brief Store @p value at @p dst, bypassing the cache if @p STREAM.
+     */
+    template <bool STREAM>
+    static void store(float* dst, float value) {
+#if defined(__SSE2__)
+        if constexpr (STREAM) {
+            int bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            _mm_stream_si32(reinterpret_cast<int*>(dst), bits);
+            return;
+        }
+#endif
+        *dst = value;
+    }
+
+    /**
+     * @brief Zero the voxels of slice @p z that no kernel window fits around.
+     */
+    void zero_slice_border(int z) const {
+        float* out = output_;
+        for (int r = 0; r < IMG_HEIGHT; ++r) {
+            float* row = out + get_index(z, r, 0);
+            if (r < BORDER || r >= IMG_HEIGHT - BORDER) {
+                std::fill_n(row, IMG_WIDTH, 0.0f);
+            } else {
+                std::fill_n(row, BORDER, 0.0f);
+                std::fill_n(row + IMG_WIDTH - BORDER, BORDER, 0.0f);
+            }
+        }
+    }
+
+    /**
+     * @brief One SIMD register of floats: 8 with AVX, otherwise 4 (SSE, NEON).
+     */
+#if defined(__AVX__)
+    typedef float Vec __attribute__((vector_size(32)));
+#else
+    typedef float Vec __attribute__((vector_size(16)));
+#endif
+    static constexpr int VEC_WIDTH = sizeof(Vec) / sizeof(float);
+
+    /**
+     * @brief Output block computed per microkernel call: slices x rows x columns.
+     *
+     * 2 x 2 x (2 vectors) outputs are eight `Vec` accumulators, which the fully
+     * unrolled block keeps in registers next to the six shifted tap vectors of
+     * the current input row (sixteen accumulators spill with SSE and AVX). Each
+     * input row segment is loaded once per block and feeds up to four
+     * accumulator rows: 16 row loads per 4 output rows instead of 9 per row.
+     */
+    static constexpr int BLOCK_SLICES = 2;
+    static constexpr int BLOCK_ROWS = 2;
+    static constexpr int BLOCK_COLS = 2 * VEC_WIDTH;
+
+    /**
+     * @brief Whether the interior is large enough for whole blocks.
+     */
+    static constexpr bool BLOCKED = IMG_HEIGHT - 2 * BORDER >= BLOCK_ROWS && IMG_WIDTH - 2 * BORDER >= BLOCK_COLS;
+
+    /**
+     * @brief Unaligned load of a `Vec` at @p p.
+     */
+    static Vec load(const float* p) {
+        Vec v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    /**
+     * @brief Compute the @p NZ x `BLOCK_ROWS` x `BLOCK_COLS` outputs whose first
+     *        voxel is (z, y, x).
+     *
+     * Each of the `(NZ + 2) * (BLOCK_ROWS + 2)` input row segments is loaded
+     * once and added, with the matching kernel row, into every accumulator row
+     * whose window covers it. Every output voxel sums its kernel rows in the
+     * same (kz, ky) order whatever the block shape, so overlapping blocks and
+     * different slice ranges give bit-identical results.
+     */
+    template <int NZ, bool STREAM>
+    void convolve_block(const float* in, float* out, int z, int y, int x) const {
+        constexpr int IN_SLICES = NZ + KERNEL_DIM - 1;
+        constexpr int IN_ROWS = BLOCK_ROWS + KERNEL_DIM - 1;
+        constexpr int VECS = BLOCK_COLS / VEC_WIDTH;
+        const float* weights = kernel_.data();
+
+        // Everything below unrolls completely, so all indices are constants
+        Vec acc[NZ][BLOCK_ROWS][VECS] = {};
+        #pragma GCC unroll 16
+        for (int iz = 0; iz < IN_SLICES; ++iz) {
+            #pragma GCC unroll 16
+            for (int iy = 0; iy < IN_ROWS; ++iy) {
+                const float* row = in + get_index(z - BORDER + iz, y - BORDER + iy, x - BORDER);
+                Vec taps[VECS][KERNEL_DIM];
+                #pragma GCC unroll 16
+                for (int v = 0; v < VECS; ++v) {
+                    #pragma GCC unroll 16
+                    for (int kx = 0; kx < KERNEL_DIM; ++kx) {
+                        taps[v][kx] = load(row + v * VEC_WIDTH + kx);
+                    }
+                }
+                #pragma GCC unroll 16
+                for (int oz = 0; oz < NZ; ++oz) {
+                    const int kz = iz - oz;
+                    if (kz < 0 || kz >= KERNEL_DIM) {
+                        continue;
+                    }
+                    #pragma GCC unroll 16
+                    for (int oy = 0; oy < BLOCK_ROWS; ++oy) {
+                        const int ky = iy - oy;
+                        if (ky < 0 || ky >= KERNEL_DIM) {
+                            continue;
+                        }
+                        const float* w = weights + (kz * KERNEL_DIM + ky) * KERNEL_DIM;
+                        #pragma GCC unroll 16
+                        for (int v = 0; v < VECS; ++v) {
+                            Vec dot = taps[v][0] * w[0];
+                            #pragma GCC unroll 16
+                            for (int kx = 1; kx < KERNEL_DIM; ++kx) {
+                                dot += taps[v][kx] * w[kx];
+                            }
+                            acc[oz][oy][v] += dot;
+                        }
+                    }
+                }
+            }
+        }
+
+        for (int oz = 0; oz < NZ; ++oz) {
+            for (int oy = 0; oy < BLOCK_ROWS; ++oy) {
+                float* dst = out + get_index(z + oz, y + oy, x);
+                for (int v = 0; v < VECS; ++v) {
+                    if constexpr (STREAM) {
+                        for (int c = 0; c < VEC_WIDTH; ++c) {
+                            store<STREAM>(dst + v * VEC_WIDTH + c, acc[oz][oy][v][c]);
+                        }
+                    } else {
+                        std::memcpy(dst + v * VEC_WIDTH, &acc[oz][oy][v], sizeof(Vec));
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Compute the interior of slices [z, z + NZ) in register blocks.
+     *
+     * Sweeps the planes row block by row block, so the input rows a block reads
+     * are still in the L1 cache for its neighbours along x and y. The last block
+     * along y and x is moved back to end at the border, recomputing a few voxels
+     * instead of needing a remainder loop.
+     */
+    template <int NZ, bool STREAM>
+    void convolve_slices(const float* in, float* out, int z) const {
+        for (int y0 = BORDER; y0 < IMG_HEIGHT - BORDER; y0 += BLOCK_ROWS) {
+            const int y = std::min(y0, IMG_HEIGHT - BORDER - BLOCK_ROWS);
+            for (int x0 = BORDER; x0 < IMG_WIDTH - BORDER; x0 += BLOCK_COLS) {
+                const int x = std::min(x0, IMG_WIDTH - BORDER - BLOCK_COLS);
+                convolve_block<NZ, STREAM>(in, out, z, y, x);
+            }
+        }
+    }
+
+    /**
+     * @brief Compute the interior of the task's slices with all kernel taps.
+     */
+    template <bool STREAM>
+    void convolve_dense(const float* in, float* out) const {
+        if constexpr (BLOCKED) {
+            // Interior in register blocks, `BLOCK_SLICES` slices of the task's range
+            // at a time (one for an odd slice left over)
+            int z = start_slice_;
+            for (; z + BLOCK_SLICES <= end_slice_; z += BLOCK_SLICES) {
+                convolve_slices<BLOCK_SLICES, STREAM>(in, out, z);
+            }
+            if (z < end_slice_) {
+                convolve_slices<1, STREAM>(in, out, z);
+            }
+        } else {
+            // Volumes narrower than one block: one voxel at a time
+            for (int z = start_slice_; z < end_slice_; ++z) {
+                for (int r = BORDER; r < IMG_HEIGHT - BORDER; ++r) {
+                    for (int c = BORDER; c < IMG_WIDTH - BORDER; ++c) {
+                        float sum = 0.0f;
+                        int kernel_idx = 0;
+
+                        // Iterate over the 3D kernel window (kz, kr, kc)
+                        for (int kz = -BORDER; kz <= BORDER; ++kz) {
+                            for (int kr = -BORDER; kr <= BORDER; ++kr) {
+                                for (int kc = -BORDER; kc <= BORDER; ++kc) {
+                                    sum += in[get_index(z + kz, r + kr, c + kc)] * kernel_[kernel_idx++];
+                                }
+                            }
+                        }
+                        store<STREAM>(out + get_index(z, r, c), sum);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Compute the interior of the task's slices from the `SINGLES` single
+     *        and `PAIRS` mirrored-pair terms of a sparse kernel.
+     *
+     * The term counts are template arguments, so the loop over the terms
+     * unrolls completely and each term is one vectorised pass along the row:
+     * one (single) or two (pair) loads and a multiply-add per output.
+     */
+    template <int SINGLES, int PAIRS, KernelSymmetry SYMMETRY, bool STREAM>
+    void convolve_sparse(const float* in, float* out) const {
+        constexpr int INTERIOR_WIDTH = IMG_WIDTH - 2 * BORDER;
+
+        // Terms as offsets into the volume (one spare entry avoids empty arrays)
+        int offset[SINGLES + PAIRS + 1] = {};
+        float weight[SINGLES + PAIRS + 1] = {};
+        for (int t = 0; t < SINGLES + PAIRS; ++t) {
+            const KernelTerm& term = structure_.terms[t];
+            offset[t] = get_index(term.dz, term.dy, term.dx);
+            weight[t] = term.weight;
+        }
+
+        for (int z = start_slice_; z < end_slice_; ++z) {
+            for (int r = BORDER; r < IMG_HEIGHT - BORDER; ++r) {
+                const float* src = in + get_index(z, r, BORDER);
+
+                // One pass along the row per term keeps every loop a plain vector stream
+                float acc[INTERIOR_WIDTH] = {};
+                #pragma GCC unroll 16
+                for (int t = 0; t < SINGLES; ++t) {
+                    const float* tap = src + offset[t];
+                    for (int c = 0; c < INTERIOR_WIDTH; ++c) {
+                        acc[c] += tap[c] * weight[t];
+                    }
+                }
+                #pragma GCC unroll 16
+                for (int t = SINGLES; t < SINGLES + PAIRS; ++t) {
+                    const float* plus = src + offset[t];
+                    const float* minus = src - offset[t];
+                    for (int c = 0; c < INTERIOR_WIDTH; ++c) {
+                        const float pair = SYMMETRY == KernelSymmetry::odd ? plus[c] - minus[c] : plus[c] + minus[c];
+                        acc[c] += pair * weight[t];
+                    }
+                }
+
+                float* dst = out + get_index(z, r, BORDER);
+                for (int c = 0; c < INTERIOR_WIDTH; ++c) {
+                    store<STREAM>(dst + c, acc[c]);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Select the `convolve_sparse` instantiation for `structure_`'s term counts.
+     *
+     * Instantiated for every combination the analysis can produce: up to
+     * `MAX_SPARSE_TERMS` singles for asymmetric kernels, the optional centre
+     * plus up to `MAX_SPARSE_TERMS` pairs for symmetric ones.
+     */
+    template <bool STREAM, int SINGLES, int PAIRS, KernelSymmetry SYMMETRY>
+    void dispatch_sparse(const float* in, float* out) const {
+        constexpr int MAX_TERMS = KernelStructure::MAX_SPARSE_TERMS;
+
+        if constexpr (SYMMETRY == KernelSymmetry::none && SINGLES == 0) {
+            // Entry point: branch on the symmetry first
+            if (structure_.symmetry == KernelSymmetry::even) {
+                dispatch_sparse<STREAM, 0, 0, KernelSymmetry::even>(in, out);
+                return;
+            }
+            if (structure_.symmetry == KernelSymmetry::odd) {
+                dispatch_sparse<STREAM, 0, 0, KernelSymmetry::odd>(in, out);
+                return;
+            }
+        }
+
+        if (structure_.singles == SINGLES && structure_.pairs == PAIRS) {
+            convolve_sparse<SINGLES, PAIRS, SYMMETRY, STREAM>(in, out);
+        } else if constexpr (SYMMETRY == KernelSymmetry::none) {
+            if constexpr (SINGLES < MAX_TERMS) {
+                dispatch_sparse<STREAM, SINGLES + 1, 0, SYMMETRY>(in, out);
+            }
+        } else if constexpr (SINGLES + PAIRS < MAX_TERMS) {
+            dispatch_sparse<STREAM, SINGLES, PAIRS + 1, SYMMETRY>(in, out);
+        } else if constexpr (SYMMETRY == KernelSymmetry::even && SINGLES == 0) {
+            // Only an even kernel can have a non-zero centre
+            dispatch_sparse<STREAM, 1, 0, SYMMETRY>(in, out);
+        }
+    }
+
+    /**
+     * @brief Compute the interior of the task's slices for a box kernel.
+     *
+     * Window sums are separable: each input plane is summed over the x window,
+     * then the y window, once, and each output adds the `KERNEL_DIM` plane sums
+     * around it from a ring buffer that slides up the task's slices, so a
+     * range of n slices sums n + 2 planes; one multiplication scales the
+     * result. Every output adds its window in the same order whatever the
+     * task's slice range.
+     */
+    template <bool STREAM>
+    void convolve_box(const float* in, float* out) const {
+        constexpr int INTERIOR_WIDTH = IMG_WIDTH - 2 * BORDER;
+        constexpr int INTERIOR_HEIGHT = IMG_HEIGHT - 2 * BORDER;
+        constexpr int PLANE = INTERIOR_WIDTH * INTERIOR_HEIGHT;
+        const float weight = structure_.box_weight;
+
+        // KERNEL_DIM plane sums, then the x-window sums of every row of one plane;
+        // each is written before it is read. Allocated once per thread (with huge
+        // pages for large volumes) rather than by every task.
+        static thread_local Image scratch(KERNEL_DIM * PLANE + IMG_HEIGHT * INTERIOR_WIDTH, UNINITIALISED_VOXELS);
+        float* row_sums = scratch.data() + KERNEL_DIM * PLANE;
+        auto plane_sum = [&](int z) {
+            return scratch.data() + z % KERNEL_DIM * PLANE;
+        };
+
+        // One pass along the row per window offset keeps every loop a plain
+        // vector stream, adding in the same order as a scalar window sum
+        auto sum_plane = [&](int z) {
+            for (int r = 0; r < IMG_HEIGHT; ++r) {
+                const float* src = in + get_index(z, r, 0);
+                float acc[INTERIOR_WIDTH] = {};
+                #pragma GCC unroll 16
+                for (int kx = 0; kx < KERNEL_DIM; ++kx) {
+                    for (int c = 0; c < INTERIOR_WIDTH; ++c) {
+                        acc[c] += src[c + kx];
+                    }
+                }
+                std::copy_n(acc, INTERIOR_WIDTH, row_sums + r * INTERIOR_WIDTH);
+            }
+            float* dst = plane_sum(z);
+            for (int r = 0; r < INTERIOR_HEIGHT; ++r) {
+                float acc[INTERIOR_WIDTH] = {};
+                #pragma GCC unroll 16
+                for (int ky = 0; ky < KERNEL_DIM; ++ky) {
+                    const float* src = row_sums + (r + ky) * INTERIOR_WIDTH;
+                    for (int c = 0; c < INTERIOR_WIDTH; ++c) {
+                        acc[c] += src[c];
+                    }
+                }
+                std::copy_n(acc, INTERIOR_WIDTH, dst + r * INTERIOR_WIDTH);
+            }
+        };
+
+        for (int z = start_slice_ - BORDER; z < start_slice_ + BORDER; ++z) {
+            sum_plane(z);
+        }
+        for (int z = start_slice_; z < end_slice_; ++z) {
+            sum_plane(z + BORDER);
+            for (int r = 0; r < INTERIOR_HEIGHT; ++r) {
+                float acc[INTERIOR_WIDTH] = {};
+                #pragma GCC unroll 16
+                for (int kz = 0; kz < KERNEL_DIM; ++kz) {
+                    const float* src = plane_sum(z - BORDER + kz) + r * INTERIOR_WIDTH;
+                    for (int c = 0; c < INTERIOR_WIDTH; ++c) {
+                        acc[c] += src[c];
+                    }
+                }
+                float* dst = out + get_index(z, r + BORDER, BORDER);
+                for (int c = 0; c < INTERIOR_WIDTH; ++c) {
+                    store<STREAM>(dst + c, acc[c] * weight);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Convolve slices [start_slice_, end_slice_) and zero their borders.
+     */
+    template <bool STREAM>
+    void run_slices() const {
+        const float* in = input_;
+        float* out = output_;
+
+        // Border planes belong to the tasks at either end of the volume
+        if (start_slice_ == BORDER) {
+            std::fill_n(out, BORDER * IMG_WIDTH * IMG_HEIGHT, 0.0f);
+        }
+        if (end_slice_ == IMG_DEPTH - BORDER) {
+            std::fill_n(out + get_index(IMG_DEPTH - BORDER, 0, 0), BORDER * IMG_WIDTH * IMG_HEIGHT, 0.0f);
+        }
+
+        for (int z = start_slice_; z < end_slice_; ++z) {
+            zero_slice_border(z);
+        }
+
+        switch (structure_.pattern) {
+            case KernelPattern::box:
+                convolve_box<STREAM>(in, out);
+                break;
+            case KernelPattern::sparse:
+                dispatch_sparse<STREAM, 0, 0, KernelSymmetry::none>(in, out);
+                break;
+            case KernelPattern::dense:
+                convolve_dense<STREAM>(in, out);
+                break;
+        }
+
+#if defined(__SSE2__)
+        if constexpr (STREAM) {
+            // Non-temporal stores are weakly ordered: drain them before signalling
+            _mm_sfence();
+        }
+#endif
+    }
+
 public:
     /**
      * @brief Construct a convolution task for a range of depth slices.
@@ -144,65 +656,104 @@ public:
      * @param kernel The 3x3x3 convolution kernel (27 floats, const reference).
      * @param start_slice Starting z-coordinate (inclusive).
      * @param end_slice Ending z-coordinate (exclusive).
-     * @param completed_slices_counter Atomic counter for synchronization (reference).
+     * @param completed_slices_counter Sharded counter for synchronization (reference).
+     * @param stream_output Write the results with non-temporal stores; worth it
+     *        only when the output is far larger than the last-level cache
+     *        (`streaming_stores_pay_off`) and not read again soon.
+     */
+    ConvolutionTask(
+        const Image& input,
+        Image& output,
+        const std::vector<float>& kernel,
+        int start_slice,
+        int end_slice,
+        ShardedCounter& completed_slices_counter,
+        bool stream_output = false)
+        : ConvolutionTask(input, output, kernel, KernelStructure::analyse(kernel), start_slice, end_slice,
+                          completed_slices_counter, stream_output)
+    {}
+
+    /**
+     * @brief Construct a convolution task for a kernel analysed beforehand.
+     *
+     * Callers that create many tasks for one kernel analyse it once and pass
+     * the result (which must be `KernelStructure::analyse(kernel)`).
      */
     ConvolutionTask(
         const Image& input,
         Image& output,
         const std::vector<float>& kernel,
+        const KernelStructure& structure,
         int start_slice,
         int end_slice,
-        std::atomic<int>& completed_slices_counter)
+        ShardedCounter& completed_slices_counter,
+        bool stream_output = false)
+        : ConvolutionTask(input.data(), output.data(), kernel, structure, start_slice, end_slice,
+                          completed_slices_counter, stream_output)
+    {}
+
+    /**
+     * @brief Construct a convolution task on volumes held elsewhere, e.g. one
+     *        channel of a planar multi-channel volume.
+     *
+     * @param input First voxel of a `VOLUME_SIZE`-voxel input volume.
+     * @param output First voxel of a `VOLUME_SIZE`-voxel output volume.
+     */
+    ConvolutionTask(
+        const float* input,
+        float* output,
+        const std::vector<float>& kernel,
+        const KernelStructure& structure,
+        int start_slice,
+        int end_slice,
+        ShardedCounter& completed_slices_counter,
+        bool stream_output = false)
         : input_(input),
           output_(output),
           kernel_(kernel),
+          structure_(structure),
           start_slice_(start_slice),
           end_slice_(end_slice),
-          completed_slices_counter_(completed_slices_counter)
+          completed_slices_counter_(completed_slices_counter),
+          stream_output_(stream_output)
     {}
 
     /**
      * @brief Execute the convolution on the assigned slice range (functor call operator).
      *
      * Iterates over z in [start_slice_, end_slice_) and all valid (y, x) positions,
-     * computing the 3D convolution for each output voxel. Updates the completion
-     * counter when finished.
+     * computing the 3D convolution for each output voxel and zeroing the rest.
+     * Updates the completion counter when finished.
      */
     void operator()() const {
-        // Loops over the assigned depth slice range (Z-axis)
-        for (int z = start_slice_; z < end_slice_; ++z) {
-            // Loops over rows (Y-axis) and columns (X-axis)
-            for (int r = BORDER; r < IMG_HEIGHT - BORDER; ++r) {
-                for (int c = BORDER; c < IMG_WIDTH - BORDER; ++c) {
-                    
-                    float sum = 0.0f;
-                    int kernel_idx = 0;
-                    
-                    // Iterate over the 3D kernel window (kz, kr, kc)
-                    for (int kz = -BORDER; kz <= BORDER; ++kz) {
-                        for (int kr = -BORDER; kr <= BORDER; ++kr) {
-                            for (int kc = -BORDER; kc <= BORDER; ++kc) {
-                                
-                                int iz = z + kz;
-                                int ir = r + kr;
-                                int ic = c + kc;
-                                
-                                int input_idx = get_index(iz, ir, ic);
-                                float k_val = kernel_[kernel_idx++];
-                                
-                                sum += input_[input_idx] * k_val;
-                            }
-                        }
-                    }
-                    
-                    // Write the calculated value to the output image
-                    output_[get_index(z, r, c)] = sum;
-                }
-            }
+        if (stream_output_) {
+            run_slices<true>();
+        } else {
+            run_slices<false>();
         }
         
-        // Signal completion using the atomic counter
-        completed_slices_counter_.fetch_add(end_slice_ - start_slice_);
+        // Signal completion on this worker's shard of the counter
+        completed_slices_counter_.add(end_slice_ - start_slice_);
+    }
+
+    /**
+     * @brief Intrusive entry point, run by a pool worker after `submit(task)`.
+     */
+    void execute() override {
+        (*this)();
+    }
+
+    /**
+     * @brief Slices per task when the interior is shared among @p workers.
+     *
+     * A multiple of `BLOCK_SLICES`, so the dense microkernel computes whole
+     * blocks of slices and the box path reuses plane sums between neighbouring
+     * slices; small enough that every worker still gets about two ranges.
+     */
+    static int slice_grain(int workers) {
+        constexpr int SLICES = IMG_DEPTH - 2 * BORDER;
+        const int per_range = SLICES / std::max(2 * workers, 1);
+        return std::max(BLOCK_SLICES, per_range / BLOCK_SLICES * BLOCK_SLICES);
     }
 };
 
@@ -301,62 +852,297 @@ inline float calculate_std_dev(const Image& img, const std::string& label) {
     return std_dev;
 }
 
+/**
+ * @brief Apply a kernel @p iterations times, running all workers in lock-step (SPMD).
+ *
+ * @param pool Reference to the ThreadPool for parallel execution.
+ * @param input The input 3D volume (const reference).
+ * @param[out] output Result of the last iteration (border voxels are zero).
+ * @param kernel The convolution kernel: 27 floats for 3x3x3 (const reference).
+ * @param kernel_name Descriptive name of the kernel (for logging).
+ * @param iterations Number of times the kernel is applied.
+ *
+ * @details
+ * Produces the same result as calling `execute_convolution` @p iterations times,
+ * feeding each output back as the next input. Instead of submitting a batch of
+ * tasks per iteration and polling for it, `run_spmd` starts one instance per
+ * worker that owns a fixed block of slices for every iteration, and a pool-wide
+ * barrier separates the iterations. Two buffers (`output` and a scratch volume)
+ * are used in ping-pong fashion so the last iteration lands in `output`.
+ */
+inline void execute_iterated_convolution(ThreadPool& pool, const Image& input, Image& output,
+                                         const std::vector<float>& kernel, const std::string& kernel_name,
+                                         int iterations)
+{
+    // Every pass writes all of its buffer, borders included, so neither needs clearing
+    Image scratch(VOLUME_SIZE, UNINITIALISED_VOXELS);
+    ShardedCounter completed_slices(pool);
+    const int processable_slices = IMG_DEPTH - 2 * BORDER;
+    const bool stream = streaming_stores_pay_off(output.size() * sizeof(float));
+    const KernelStructure structure = KernelStructure::analyse(kernel);
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    pool.run_spmd([&](int worker, SpinBarrier& barrier) {
+        const int workers = barrier.participants();
+        const int begin = BORDER + processable_slices * worker / workers;
+        const int end = BORDER + processable_slices * (worker + 1) / workers;
+
+        const Image* src = &input;
+        for (int it = 0; it < iterations; ++it) {
+            // Alternate buffers so that the last iteration writes `output`
+            Image& dst = (iterations - 1 - it) % 2 == 0 ? output : scratch;
+            if (begin < end) {
+                ConvolutionTask(*src, dst, kernel, structure, begin, end, completed_slices, stream)();
+            }
+            // Nobody may read dst (or overwrite src) until every block is done
+            barrier.arrive_and_wait();
+            src = &dst;
+        }
+    });
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+
+    std::cout << "\n[Filter: " << kernel_name << "] " << iterations << " lock-step iterations on "
+              << pool.size() << " workers in " << duration.count() << " us" << std::endl;
+}
+
+/**
+ * @brief Write a volume to a file as raw native-endian floats, slice after slice.
+ *
+ * @param volume The 3D volume to store (const reference).
+ * @param path Destination file, created or truncated.
+ * @return true if every byte was written.
+ */
+inline bool save_volume(const Image& volume, const std::string& path) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(volume.data()), static_cast<std::streamsize>(volume.size() * sizeof(float)));
+    return static_cast<bool>(file);
+}
+
+/**
+ * @brief Load a raw volume with asynchronous reads and filter it while it streams in.
+ *
+ * @param pool Reference to the ThreadPool for parallel execution (call from outside it).
+ * @param path File written by `save_volume`.
+ * @param[out] input Receives the loaded volume (resized to VOLUME_SIZE).
+ * @param[out] output The output 3D volume (every slice with complete input is filtered).
+ * @param kernel The convolution kernel: 27 floats for 3x3x3 (const reference).
+ * @param kernel_name Descriptive name of the kernel (for logging).
+ * @return true if the file was read completely.
+ *
+ * @details
+ * One `read_async` per z-slice is queued on the pool's I/O rings; no worker
+ * blocks on the disk. The output is split into ranges of
+ * `ConvolutionTask::slice_grain` slices; each completion counts itself towards
+ * the ranges whose windows need it, and the completion that supplies a range's
+ * last input slice submits that range's intrusive convolution task, so
+ * filtering overlaps with the remaining reads.
+ */
+inline bool load_and_convolve(ThreadPool& pool, const std::string& path, Image& input, Image& output,
+                              const std::vector<float>& kernel, const std::string& kernel_name)
+{
+    constexpr int SLICE_VOXELS = IMG_WIDTH * IMG_HEIGHT;
+    constexpr size_t SLICE_BYTES = SLICE_VOXELS * sizeof(float);
+    const int processable_slices = IMG_DEPTH - 2 * BORDER;
+
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "Cannot open volume " << path << std::endl;
+        return false;
+    }
+
+    input.resize(VOLUME_SIZE);
+    ShardedCounter completed_slices(pool);
+    const bool stream = streaming_stores_pay_off(output.size() * sizeof(float));
+    const KernelStructure structure = KernelStructure::analyse(kernel);
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    // Range [lo, hi) can be filtered once slices lo-1 to hi are loaded
+    const int grain = ConvolutionTask::slice_grain(pool.size());
+    const int ranges = (processable_slices + grain - 1) / grain;
+    std::vector<std::atomic<int>> loaded_inputs(ranges);
+    std::vector<ConvolutionTask> tasks;
+    tasks.reserve(ranges);
+    for (int z = BORDER; z < IMG_DEPTH - BORDER; z += grain) {
+        tasks.emplace_back(input, output, kernel, structure, z, std::min(z + grain, IMG_DEPTH - BORDER),
+                           completed_slices, stream);
+    }
+    auto range_begin = [&](int r) { return BORDER + r * grain; };
+    auto range_end = [&](int r) { return std::min(range_begin(r) + grain, IMG_DEPTH - BORDER); };
+
+    static const TaskTag slice_tag("ConvolutionTask streamed range");
+    std::atomic<int> reads_done{0};
+    std::atomic<int> submitted{0};
+    std::atomic<bool> failed{false};
+
+    for (int s = 0; s < IMG_DEPTH; ++s) {
+        pool.read_async(fd, &input[s * SLICE_VOXELS], SLICE_BYTES, s * SLICE_BYTES, [&, s](ssize_t n) {
+            if (n != static_cast<ssize_t>(SLICE_BYTES)) {
+                failed.store(true);
+            } else {
+                // Slice s is an input of at most the two ranges around s - BORDER
+                // (a range is at least 2 * BORDER slices long)
+                for (int r = std::max(0, (s - BORDER) / grain - 1); r < ranges && r <= s / grain; ++r) {
+                    if (s < range_begin(r) - BORDER || s >= range_end(r) + BORDER) {
+                        continue;
+                    }
+                    const int needed = range_end(r) - range_begin(r) + 2 * BORDER;
+                    if (loaded_inputs[r].fetch_add(1) + 1 == needed) {
+                        submitted.fetch_add(range_end(r) - range_begin(r));
+                        pool.submit(tasks[r], slice_tag);
+                    }
+                }
+            }
+            reads_done.fetch_add(1);
+        });
+    }
+
+    // Wait for every read, then for every slice whose inputs all arrived
+    while (reads_done.load() < IMG_DEPTH || completed_slices.sum() < submitted.load()) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    ::close(fd);
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+
+    std::cout << "\n[Filter: " << kernel_name << "] Streamed " << IMG_DEPTH << " slices via "
+              << (pool.io_uring_enabled() ? "io_uring" : "blocking I/O threads") << " and filtered "
+              << completed_slices.sum() << " in " << duration.count() << " us" << std::endl;
+    return !failed.load();
+}
+
+/**
+ * @brief Render interactive previews of a few z-slices as deadline-class tasks.
+ *
+ * @param pool Reference to the ThreadPool for parallel execution.
+ * @param input The input 3D volume (const reference).
+ * @param[out] output The output 3D volume; only the previewed slices are written.
+ * @param kernel The convolution kernel: 27 floats for 3x3x3 (const reference).
+ * @param slices Z-coordinates of the slices to preview (each within the borders).
+ * @param budget Time each preview must finish within, e.g. one 60 Hz frame.
+ *
+ * @details
+ * Each slice is submitted with `submit_within`, so the pool runs the previews
+ * ahead of any queued bulk work, earliest deadline first. Blocks until all
+ * previews are done; hits and misses accumulate in `pool.deadline_stats()`.
+ */
+inline void execute_slice_previews(ThreadPool& pool, const Image& input, Image& output,
+                                   const std::vector<float>& kernel, const std::vector<int>& slices,
+                                   std::chrono::milliseconds budget)
+{
+    ShardedCounter completed_slices(pool);
+    const int total = static_cast<int>(slices.size());
+    const KernelStructure structure = KernelStructure::analyse(kernel);
+
+    for (int z : slices) {
+        pool.submit_within(budget, [&input, &output, &kernel, &structure, z, &completed_slices] {
+            ConvolutionTask(input, output, kernel, structure, z, z + 1, completed_slices)();
+        });
+    }
+
+    // Wait for Completion 
+    while (completed_slices.sum() < total) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
 /**
  * @brief Execute 3D convolution with a specified kernel using the thread pool.
  *
  * @param pool Reference to the ThreadPool for parallel execution.
  * @param input The input 3D volume (const reference).
- * @param[out] output The output 3D volume (mutable reference, will be zeroed).
+ * @param[out] output The output 3D volume (mutable reference, fully overwritten).
  * @param kernel The convolution kernel: 27 floats for 3x3x3 (const reference).
  * @param kernel_name Descriptive name of the kernel (for logging).
+ * @param schedule Task decomposition strategy (heartbeat-driven by default).
  *
  * @details
- * - Submits one task per z-slice to the thread pool for parallel processing.
- * - Blocks until all tasks complete (monitored via atomic counter).
+ * - With `ConvolutionSchedule::per_slice`, submits one intrusive task per range of
+ *   `ConvolutionTask::slice_grain` z-slices to the thread pool (no per-task copies
+ *   or allocations); with `ConvolutionSchedule::heartbeat`, lets `heartbeat_for_chunks`
+ *   create only as many tasks as the volume size and idle workers warrant.
+ * - Blocks until all tasks complete.
  * - Logs timing information, center, and edge voxel values for verification.
  * - Commented verification code allows deeper analysis of filter effects.
  *
  * @note
- * The output buffer is reset to zero before processing. This function blocks
- * the caller until all convolution tasks complete.
+ * The output needs no initialisation: the slice tasks write every voxel, zeroing
+ * the border ones, and use non-temporal stores for outputs far larger than the
+ * last-level cache. This function blocks the caller until all convolution tasks
+ * complete.
  */
 inline void execute_convolution(ThreadPool& pool, const Image& input, Image& output, 
-                         const std::vector<float>& kernel, const std::string& kernel_name) 
+                         const std::vector<float>& kernel, const std::string& kernel_name,
+                         ConvolutionSchedule schedule = ConvolutionSchedule::heartbeat) 
 {
     using namespace std::literals;
 
-    // Reset output image to zero before each filter run
-    std::fill(output.begin(), output.end(), 0.0f);
-    std::atomic<int> completed_slices = 0;
+    ShardedCounter completed_slices(pool);
     int processable_slices = IMG_DEPTH - 2 * BORDER;
+    const bool stream = streaming_stores_pay_off(output.size() * sizeof(float));
+
+    // Analysed once here rather than by every slice task
+    const KernelStructure structure = KernelStructure::analyse(kernel);
+    const int grain = ConvolutionTask::slice_grain(pool.size());
     
     auto start_time = std::chrono::high_resolution_clock::now();
 
-    // Iterate over the depth axis (Z) and submit one task per slice
-    for (int z = BORDER; z < IMG_DEPTH - BORDER; ++z) {
-        ConvolutionTask task(
-            input, 
-            output, 
-            kernel, 
-            z,          // start_slice
-            z + 1,      // end_slice (processing one slice at a time)
-            completed_slices
-        );
-        
-        // Use a lambda to wrap the functor for submission to the ThreadPool
-        pool.submit([task](){ task(); });
-    }
+    // Call-site tags, so the pool's grain report can tell the two schedules apart
+    static const TaskTag slice_tag("ConvolutionTask slice");
+    static const TaskTag range_tag("ConvolutionTask heartbeat range");
 
-    std::cout << "\n[Filter: " << kernel_name << "] Submitted " << processable_slices << " tasks." << std::endl;
+    if (schedule == ConvolutionSchedule::heartbeat) {
+        HeartbeatOptions options;
+        options.tag = &range_tag;
 
-    // Wait for Completion 
-    while (completed_slices.load() < processable_slices) {
-        std::this_thread::sleep_for(1ms); 
+        // Slice ranges run serially on this thread unless a heartbeat or an idle
+        // worker makes splitting worthwhile; returns once every slice is done.
+        long promoted = heartbeat_for_chunks(pool, BORDER, IMG_DEPTH - BORDER, grain, [&](long lo, long hi) {
+            ConvolutionTask(input, output, kernel, structure, (int)lo, (int)hi, completed_slices, stream)();
+        }, options);
+
+        std::cout << "\n[Filter: " << kernel_name << "] Processed " << processable_slices
+                  << " slices with " << promoted << " promoted tasks." << std::endl;
+    } else {
+        // One work item per slice range, owned here and linked into the pool's queues
+        // by reference; reserve() keeps their addresses stable while they are queued.
+        std::vector<ConvolutionTask> tasks;
+        tasks.reserve((processable_slices + grain - 1) / grain);
+
+        // Iterate over the depth axis (Z) and submit one task per range of `grain` slices
+        for (int z = BORDER; z < IMG_DEPTH - BORDER; z += grain) {
+            tasks.emplace_back(
+                input, 
+                output, 
+                kernel, 
+                structure,
+                z,                                          // start_slice
+                std::min(z + grain, IMG_DEPTH - BORDER),    // end_slice
+                completed_slices,
+                stream
+            );
+        }
+        for (ConvolutionTask& task : tasks) {
+            pool.submit(task, slice_tag);
+        }
+
+        std::cout << "\n[Filter: " << kernel_name << "] Submitted " << tasks.size() << " tasks of up to "
+                  << grain << " slices." << std::endl;
+
+        // Wait for Completion 
+        while (completed_slices.sum() < processable_slices) {
+            std::this_thread::sleep_for(1ms); 
+        }
     }
     
     auto end_time = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
+    std::cout << "Kernel: " << structure << std::endl;
     std::cout << "Time taken for parallel processing: " << duration.count() << " ms" << std::endl;
 
     // --- VERIFICATION ---
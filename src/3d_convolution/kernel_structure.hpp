@@ -0,0 +1,211 @@
+#ifndef __KERNEL_STRUCTURE_HPP__
+#define __KERNEL_STRUCTURE_HPP__
+
+#include <array>
+#include <ostream>
+#include <vector>
+
+/**
+ * @file kernel_structure.hpp
+ * @brief One-off analysis of a convolution kernel's zero pattern and symmetry.
+ *
+ * Most filters used on volumes are far from dense: a first derivative along z
+ * has 2 non-zero taps out of 27, the 7-point Laplacian 7, and both are mirror
+ * symmetric, so pairs of taps share a weight. A uniform box needs no
+ * multiplications at all beyond the final scaling. `ConvolutionTask` analyses
+ * its kernel once and runs a code path specialised for what it found.
+ *
+ * @details
+ * - *Mirror symmetry* relates the tap at offset d to the tap at -d: *even* when
+ *   w(-d) = w(d), *odd* when w(-d) = -w(d). A symmetric kernel is reduced to
+ *   *terms*: the centre tap (if non-zero) on its own, plus one term per mirrored
+ *   pair, applied as `(in[+d] + in[-d]) * w` or `(in[+d] - in[-d]) * w`.
+ * - A kernel with at most `MAX_SPARSE_TERMS` terms is *sparse* and is run by a
+ *   template instantiated for its exact term counts; a kernel whose taps are
+ *   all equal is a *box*; everything else is *dense*.
+ * - Weights are compared exactly: a kernel that is symmetric only up to
+ *   rounding is treated as asymmetric, never approximated.
+ *
+ * @author dssregi
+ * @version 1.0
+ * @date 2025-11-14
+ */
+
+/**
+ * @brief Code path a kernel is run with.
+ */
+enum class KernelPattern {
+    dense,      ///< All taps, register-blocked.
+    sparse,     ///< Only the non-zero taps, symmetric pairs folded.
+    box         ///< All taps equal: sliding window sums, one multiplication.
+};
+
+/**
+ * @brief Mirror symmetry of a kernel through its centre.
+ */
+enum class KernelSymmetry {
+    none,       ///< No exact relation between w(d) and w(-d).
+    even,       ///< w(-d) = w(d), e.g. blurs and the Laplacian.
+    odd         ///< w(-d) = -w(d), e.g. first derivatives.
+};
+
+/**
+ * @brief Name of a pattern, for reports.
+ */
+inline const char* to_string(KernelPattern pattern) {
+    switch (pattern) {
+        case KernelPattern::dense: return "dense";
+        case KernelPattern::sparse: return "sparse";
+        case KernelPattern::box: return "box";
+    }
+    return "?";
+}
+
+/**
+ * @brief Name of a symmetry, for reports.
+ */
+inline const char* to_string(KernelSymmetry symmetry) {
+    switch (symmetry) {
+        case KernelSymmetry::none: return "none";
+        case KernelSymmetry::even: return "even";
+        case KernelSymmetry::odd: return "odd";
+    }
+    return "?";
+}
+
+/**
+ * @brief One term of a sparse kernel: a tap, or the positive side of a mirrored pair.
+ */
+struct KernelTerm {
+    int dz = 0;             ///< Offset along z from the output voxel.
+    int dy = 0;             ///< Offset along y.
+    int dx = 0;             ///< Offset along x.
+    float weight = 0.0f;    ///< Weight of the tap at (dz, dy, dx).
+};
+
+/**
+ * @brief Structure of a `DIM` x `DIM` x `DIM` kernel, stored z-major like the volume.
+ *
+ * @tparam DIM Kernel edge length (odd).
+ */
+template <int DIM>
+struct BasicKernelStructure {
+    static_assert(DIM % 2 == 1, "Kernels are centred on the output voxel");
+
+    /**
+     * @brief Number of taps of the kernel.
+     */
+    static constexpr int TAPS = DIM * DIM * DIM;
+
+    /**
+     * @brief Largest number of terms run by the sparse path; denser kernels
+     *        are faster register-blocked.
+     */
+    static constexpr int MAX_SPARSE_TERMS = 8;
+
+    KernelPattern pattern = KernelPattern::dense;
+    KernelSymmetry symmetry = KernelSymmetry::none;
+
+    /**
+     * @brief Non-zero taps of the kernel.
+     */
+    int nonzero = 0;
+
+    /**
+     * @brief Terms applied on their own: the first `singles` entries of `terms`.
+     */
+    int singles = 0;
+
+    /**
+     * @brief Mirrored pairs: the `pairs` entries of `terms` after the singles.
+     */
+    int pairs = 0;
+
+    /**
+     * @brief Singles, then the positive side of each pair (sparse kernels only).
+     */
+    std::array<KernelTerm, TAPS> terms{};
+
+    /**
+     * @brief The common weight of a box kernel.
+     */
+    float box_weight = 0.0f;
+
+    /**
+     * @brief Analyse a kernel of `TAPS` weights (index = z*DIM*DIM + y*DIM + x).
+     */
+    static BasicKernelStructure analyse(const std::vector<float>& kernel) {
+        BasicKernelStructure s;
+        constexpr int RADIUS = DIM / 2;
+        constexpr int CENTRE = TAPS / 2;
+
+        auto term = [](int index, float weight) {
+            return KernelTerm{index / (DIM * DIM) - RADIUS, index / DIM % DIM - RADIUS, index % DIM - RADIUS, weight};
+        };
+
+        bool even = true;
+        bool odd = true;
+        bool uniform = true;
+        for (int i = 0; i < TAPS; ++i) {
+            s.nonzero += kernel[i] != 0.0f;
+            even = even && kernel[i] == kernel[TAPS - 1 - i];
+            odd = odd && kernel[i] == -kernel[TAPS - 1 - i];
+            uniform = uniform && kernel[i] == kernel[0];
+        }
+
+        if (uniform && kernel[0] != 0.0f) {
+            s.pattern = KernelPattern::box;
+            s.symmetry = KernelSymmetry::even;
+            s.box_weight = kernel[0];
+            return s;
+        }
+
+        // An all-zero kernel is both; even keeps it a (termless) sparse kernel
+        s.symmetry = even ? KernelSymmetry::even : odd ? KernelSymmetry::odd : KernelSymmetry::none;
+        if (s.symmetry == KernelSymmetry::none) {
+            for (int i = 0; i < TAPS; ++i) {
+                if (kernel[i] != 0.0f && s.singles < MAX_SPARSE_TERMS) {
+                    s.terms[s.singles++] = term(i, kernel[i]);
+                }
+            }
+        } else {
+            if (kernel[CENTRE] != 0.0f) {
+                s.terms[s.singles++] = term(CENTRE, kernel[CENTRE]);
+            }
+            // Index TAPS - 1 - i mirrors index i; keep the positive-offset side
+            for (int i = CENTRE + 1; i < TAPS; ++i) {
+                if (kernel[i] != 0.0f && s.singles + s.pairs < MAX_SPARSE_TERMS) {
+                    s.terms[s.singles + s.pairs++] = term(i, kernel[i]);
+                }
+            }
+        }
+
+        const int needed = s.symmetry == KernelSymmetry::none ? s.nonzero : (s.nonzero + (kernel[CENTRE] != 0.0f)) / 2;
+        s.pattern = needed <= MAX_SPARSE_TERMS ? KernelPattern::sparse : KernelPattern::dense;
+        if (s.pattern == KernelPattern::dense) {
+            s.singles = 0;
+            s.pairs = 0;
+        }
+        return s;
+    }
+};
+
+/**
+ * @brief Print a one-line summary, e.g. "sparse, 7 of 27 taps in 4 terms (even symmetry)".
+ */
+template <int DIM>
+std::ostream& operator <<(std::ostream& os, const BasicKernelStructure<DIM>& s) {
+    os << to_string(s.pattern) << ", " << s.nonzero << " of " << BasicKernelStructure<DIM>::TAPS << " taps";
+    if (s.pattern == KernelPattern::sparse) {
+        const int terms = s.singles + s.pairs;
+        os << " in " << terms << (terms == 1 ? " term" : " terms");
+    } else if (s.pattern == KernelPattern::box) {
+        os << " of weight " << s.box_weight;
+    }
+    if (s.symmetry == KernelSymmetry::none) {
+        return os << " (asymmetric)";
+    }
+    return os << " (" << to_string(s.symmetry) << " symmetry)";
+}
+
+#endif // __KERNEL_STRUCTURE_HPP__
@@ -9,16 +9,47 @@
  *
  * @details
  * The program:
- * 1. Creates a ThreadPool with automatic worker thread count.
+ * 1. Creates a ThreadPool with automatic worker thread count and publishes its
+ *    per-worker statistics to the shared-memory segment `/wsp-demo`, which
+ *    `wsp-top` (src/tools/wsp_top.cpp) displays while the demo runs.
  * 2. Initializes a 24x24x24 voxel volume with synthetic data and noise.
  * 3. Defines three 3x3x3 convolution kernels:
  *    - Gaussian blur (noise reduction)
  *    - Laplacian (edge/feature detection)
  *    - Z-axis edge detector (directional edge detection)
  * 4. Executes each filter via `execute_convolution`, which submits one task
- *    per z-slice to the thread pool.
- * 5. Prints timing, sample values, and verification metrics.
- * 6. Cleans up via ThreadPool destructor.
+ *    per range of z-slices to the thread pool.
+ * 5. Prints the code path chosen for each kernel (box sums for the blur,
+ *    sparse symmetric terms for the Laplacian and the z-edge detector), timing,
+ *    sample values, and verification metrics.
+ * 6. Re-runs the blur with one task per slice range and prints the pool's grain
+ *    report, comparing per-task durations against the scheduling overhead, and the
+ *    per-task IPC and cache/TLB misses where hardware counters are available.
+ * 7. Renders three slice previews as deadline-class tasks with a 16 ms budget and
+ *    prints how many met their deadline.
+ * 8. Runs a bulk and an interactive tenant side by side and prints their quota
+ *    and CPU-time accounting.
+ * 9. Applies the blur four times in SPMD mode, one barrier per pass.
+ * 10. Applies the blur twelve times with temporal blocking and checks the result
+ *     against the same twelve passes in SPMD mode.
+ * 11. Saves the volume to a temporary file, streams it back with asynchronous reads
+ *     while filtering the slices that have arrived, and checks the result.
+ * 12. Computes per-slice statistics on the pool and collects them in an epoll loop
+ *     through a `CompletionQueue`'s eventfd.
+ * 13. Measures the per-task scheduling overhead of the throughput, low-latency and
+ *     low-power pool variants next to the default pool, and the submit-to-start
+ *     latency of parking, spinning and polling workers and of workers under
+ *     `SCHED_FIFO` and under `SCHED_BATCH` with nice 10.
+ * 14. Runs a deliberately slow tagged task under the stuck-task watchdog, which
+ *     reports it with a stack sample of its worker while it is still running.
+ * 15. Allocates a 64 MiB volume and prints how much of it landed on huge pages.
+ * 16. Builds a three-channel volume, converts it from interleaved to planar
+ *     layout on the pool, filters each channel with its own kernel in both
+ *     layouts, and mixes a blurred luminance channel with cross-channel kernels.
+ * 17. Summarises the input volume with a work-first octree recursion (coroutine
+ *     spawn/join with continuation stealing) on the default and the throughput
+ *     pool, and checks both against a serial pass.
+ * 18. Cleans up via ThreadPool destructor.
  *
  * @author dssregi
  * @version 1.0
@@ -26,6 +57,15 @@
  */
 
 #include "convolution.hpp"
+#include "temporal_stencil.hpp"
+#include "multichannel.hpp"
+#include "octree_reduction.hpp"
+#include "../core/completion_queue.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <numeric>
+#include <sys/epoll.h>
 
 /**
  * @brief Main function: initialize pool, data, kernels, and execute filters.
@@ -44,9 +84,17 @@ int main() {
     
     // --- 1. Initialization ---
     ThreadPool pool;
+    pool.enable_task_timing();
+    try {
+        pool.publish_stats("/wsp-demo");
+        std::cout << "Publishing pool statistics to /wsp-demo (watch with: wsp-top /wsp-demo)\n" << std::endl;
+    } catch (const std::system_error& e) {
+        std::cout << "Pool statistics not published: " << e.what() << "\n" << std::endl;
+    }
     
     Image input_image(VOLUME_SIZE);
-    Image output_image(VOLUME_SIZE, 0.0f);
+    // Every filter writes all of its output, borders included
+    Image output_image(VOLUME_SIZE, UNINITIALISED_VOXELS);
     
     initialize_input_with_cube(input_image);
     
@@ -82,6 +130,276 @@ int main() {
     execute_convolution(pool, input_image, output_image, LAPLACIAN_KERNEL, "3D Laplacian (Sharpening/Edge)");
     execute_convolution(pool, input_image, output_image, Z_EDGE_KERNEL, "3D Z-Axis Edge Detector");
 
+    // --- 4. Grain-size analysis ---
+
+    // Fixed slice-range-per-task decomposition, for comparison with the heartbeat schedule
+    pool.enable_task_counters();
+    execute_convolution(pool, input_image, output_image, GAUSSIAN_BLUR, "3D Gaussian Blur (one task per slice range)",
+                        ConvolutionSchedule::per_slice);
+    pool.enable_task_counters(false);
+
+    std::cout << "\n" << pool.grain_report();
+    std::cout << "\n" << pool.counter_report();
+
+    // --- 5. Deadline-bound previews ---
+
+    // Interactive previews must be ready within one 60 Hz frame
+    execute_slice_previews(pool, input_image, output_image, GAUSSIAN_BLUR, {6, 12, 18}, 16ms);
+    std::cout << "\n[Previews] " << pool.deadline_stats();
+
+    // --- 6. Tenants sharing the pool ---
+
+    // A bulk job limited to 8 tasks in flight (further submissions wait) competes
+    // with an interactive subsystem that gets 3x the share but rejects overflow
+    Tenant& bulk = pool.add_tenant({"bulk filtering", 1, 8, OverQuota::delay});
+    Tenant& interactive = pool.add_tenant({"interactive", 3, 4, OverQuota::reject});
+
+    Image bulk_output(VOLUME_SIZE);
+    ShardedCounter completed_slices(pool);
+    int accepted = 0;
+    for (int z = BORDER; z < IMG_DEPTH - BORDER; ++z) {
+        accepted += pool.submit([&, z] {
+            ConvolutionTask(input_image, bulk_output, LAPLACIAN_KERNEL, z, z + 1, completed_slices)();
+        }, bulk);
+        accepted += pool.submit([&, z] {
+            ConvolutionTask(input_image, output_image, GAUSSIAN_BLUR, z, z + 1, completed_slices)();
+        }, interactive);
+    }
+    while (completed_slices.sum() < accepted) {
+        std::this_thread::sleep_for(1ms);
+    }
+    std::cout << "\n" << pool.tenant_stats();
+
+    // --- 7. Iterated stencil in SPMD mode ---
+
+    // Four blur passes with every worker in lock-step and a barrier between passes
+    execute_iterated_convolution(pool, input_image, output_image, GAUSSIAN_BLUR, "3D Gaussian Blur x4 (SPMD)", 4);
+    calculate_std_dev(output_image, "Blur x4");
+
+    // --- 8. Temporal blocking ---
+
+    // Twelve passes, four per cache-resident tile, must match the pass-by-pass result
+    Image blocked_output(VOLUME_SIZE, UNINITIALISED_VOXELS);
+    execute_iterated_convolution(pool, input_image, output_image, GAUSSIAN_BLUR, "3D Gaussian Blur x12 (SPMD)", 12);
+    execute_temporal_convolution(pool, input_image, blocked_output, GAUSSIAN_BLUR, "3D Gaussian Blur x12 (temporal)", 12,
+                                 {4, 0});
+    float max_diff = 0.0f;
+    for (size_t i = 0; i < VOLUME_SIZE; ++i) {
+        max_diff = std::max(max_diff, std::abs(blocked_output[i] - output_image[i]));
+    }
+    std::cout << "Temporal vs. pass-by-pass max |diff|: " << max_diff << std::endl;
+
+    // --- 9. Filtering while the volume streams in from disk ---
+
+    const std::string volume_path = (std::filesystem::temp_directory_path() / "wsd_volume.raw").string();
+    if (save_volume(input_image, volume_path)) {
+        Image loaded_image;
+        Image reference(VOLUME_SIZE, UNINITIALISED_VOXELS);
+        ShardedCounter reference_slices(pool);
+        ConvolutionTask(input_image, reference, LAPLACIAN_KERNEL, BORDER, IMG_DEPTH - BORDER, reference_slices)();
+
+        if (load_and_convolve(pool, volume_path, loaded_image, output_image, LAPLACIAN_KERNEL,
+                              "3D Laplacian (streamed from disk)")) {
+            max_diff = 0.0f;
+            for (size_t i = 0; i < VOLUME_SIZE; ++i) {
+                max_diff = std::max(max_diff, std::abs(output_image[i] - reference[i]));
+            }
+            std::cout << "Streamed vs. in-memory max |diff|: " << max_diff << std::endl;
+        }
+        std::filesystem::remove(volume_path);
+    }
+
+    // --- 10. Results handed back to an event loop ---
+
+    // Per-slice means of the streamed Laplacian, gathered the way a network
+    // front-end would: wait on epoll, drain whatever has arrived
+    struct SliceMean { int z; double mean; };
+    CompletionQueue<SliceMean> slice_means;
+    for (int z = BORDER; z < IMG_DEPTH - BORDER; ++z) {
+        submit_to(pool, slice_means, [&output_image, z] {
+            const float* slice = &output_image[z * IMG_WIDTH * IMG_HEIGHT];
+            double sum = std::accumulate(slice, slice + IMG_WIDTH * IMG_HEIGHT, 0.0);
+            return SliceMean{z, sum / (IMG_WIDTH * IMG_HEIGHT)};
+        });
+    }
+
+    const int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event interest{};
+    interest.events = EPOLLIN;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, slice_means.fd(), &interest);
+
+    std::vector<SliceMean> means;
+    int wakeups = 0;
+    while (means.size() < static_cast<size_t>(IMG_DEPTH - 2 * BORDER)) {
+        epoll_event ready{};
+        if (epoll_wait(epoll_fd, &ready, 1, 1000) > 0) {
+            ++wakeups;
+            slice_means.drain(means);
+        }
+    }
+    close(epoll_fd);
+
+    auto peak = std::max_element(means.begin(), means.end(),
+                                 [](const SliceMean& a, const SliceMean& b) { return std::abs(a.mean) < std::abs(b.mean); });
+    std::cout << "\n[Event loop] Collected " << means.size() << " slice means in " << wakeups
+              << " epoll wake-ups; largest |mean| " << peak->mean << " at z=" << peak->z << std::endl;
+
+    // --- 11. Pool variants ---
+
+    // Same scheduler with other queue, idle and victim-selection policies
+    auto overhead = [](auto& variant_pool) { return variant_pool.scheduling_overhead_ns(); };
+    const double default_ns = overhead(pool);
+    double throughput_ns = 0.0;
+    double low_latency_ns = 0.0;
+    double low_power_ns = 0.0;
+    {
+        ThroughputThreadPool variant_pool;
+        throughput_ns = overhead(variant_pool);
+    }
+    {
+        LowLatencyThreadPool variant_pool;
+        low_latency_ns = overhead(variant_pool);
+    }
+    {
+        LowPowerThreadPool variant_pool;
+        low_power_ns = overhead(variant_pool);
+    }
+    std::cout << "\n[Pool variants] Scheduling overhead per task: default " << default_ns
+              << " ns, throughput " << throughput_ns << " ns, low-latency " << low_latency_ns
+              << " ns, low-power " << low_power_ns << " ns" << std::endl;
+
+    // Submit-to-start latency with idle workers: parked, spinning, polling, and
+    // under real-time and batch scheduling classes. The polling pool gets a single
+    // worker so the demo does not occupy every core.
+    auto print_latency = [](const char* mode, const SubmitLatency& latency, int options_error = 0) {
+        std::cout << "  " << mode << ": p50 " << latency.p50_ns / 1000.0 << " us, p99 " << latency.p99_ns / 1000.0
+                  << " us, max " << latency.max_ns / 1000.0 << " us";
+        if (options_error != 0) {
+            std::cout << " (scheduling options not applied: " << std::strerror(options_error) << ")";
+        }
+        std::cout << std::endl;
+    };
+    SubmitLatency parked_latency = pool.submit_latency();
+    SubmitLatency spinning_latency;
+    SubmitLatency polling_latency;
+    SubmitLatency fifo_latency;
+    SubmitLatency batch_latency;
+    int fifo_error = 0;
+    int batch_error = 0;
+    {
+        LowLatencyThreadPool variant_pool;
+        spinning_latency = variant_pool.submit_latency();
+    }
+    {
+        PollingThreadPool variant_pool(WorkerOptions{.threads = 1});
+        polling_latency = variant_pool.submit_latency();
+    }
+    {
+        ThreadPool variant_pool(WorkerOptions{.sched_class = SchedClass::fifo, .rt_priority = 10});
+        fifo_latency = variant_pool.submit_latency();
+        fifo_error = variant_pool.worker_options_error();
+    }
+    {
+        ThreadPool variant_pool(WorkerOptions{.sched_class = SchedClass::batch, .nice = 10});
+        batch_latency = variant_pool.submit_latency();
+        batch_error = variant_pool.worker_options_error();
+    }
+    std::cout << "\n[Pool variants] Submit-to-start latency with idle workers:" << std::endl;
+    print_latency("parking (default)", parked_latency);
+    print_latency("spin then park   ", spinning_latency);
+    print_latency("busy polling     ", polling_latency);
+    print_latency("SCHED_FIFO       ", fifo_latency, fifo_error);
+    print_latency("SCHED_BATCH +10  ", batch_latency, batch_error);
+
+    // --- 12. Stuck-task watchdog ---
+
+    // A slice task that takes far longer than its peers, e.g. an unexpected slow path
+    static const TaskTag stuck_tag("pathological slice");
+    std::cout << "\n[Watchdog] Threshold 50 ms; running a 200 ms task:" << std::endl;
+    pool.enable_watchdog(std::chrono::milliseconds(50));
+    std::atomic<bool> stuck_done{false};
+    pool.submit([&stuck_done] {
+        const auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+        while (std::chrono::steady_clock::now() < until) {
+            cpu_relax();
+        }
+        stuck_done.store(true);
+        stuck_done.notify_one();
+    }, stuck_tag);
+    stuck_done.wait(false);
+    pool.disable_watchdog();
+    std::cout << "[Watchdog] Long tasks counted: " << pool.long_task_count() << std::endl;
+
+    // --- 13. Huge-page backed volumes ---
+
+    // The demo volume is below the huge-page threshold; a 256^3 volume (64 MiB) is not
+    {
+        Image large_volume(size_t{256} * 256 * 256, 0.0f);
+        std::cout << "\n[Huge pages] 64 MiB volume: " << huge_page_report() << std::endl;
+    }
+
+    // --- 14. Multi-channel volumes ---
+
+    // Three fluorescence channels derived from the input, stored interleaved as
+    // acquired, converted to planar on the pool and filtered in both layouts
+    MultiChannelVolume rgb(3, ChannelLayout::interleaved);
+    for (int z = 0; z < IMG_DEPTH; ++z) {
+        for (int y = 0; y < IMG_HEIGHT; ++y) {
+            for (int x = 0; x < IMG_WIDTH; ++x) {
+                const float v = input_image[(z * IMG_HEIGHT + y) * IMG_WIDTH + x];
+                rgb.at(0, z, y, x) = v;
+                rgb.at(1, z, y, x) = 0.5f * v + 20.0f;
+                rgb.at(2, z, y, x) = 110.0f - v;
+            }
+        }
+    }
+    MultiChannelVolume rgb_planar(3, ChannelLayout::planar);
+    convert_layout(pool, rgb, rgb_planar);
+
+    const ChannelKernels per_channel = ChannelKernels::per_channel({GAUSSIAN_BLUR, LAPLACIAN_KERNEL, Z_EDGE_KERNEL});
+    MultiChannelVolume filtered(3, ChannelLayout::interleaved);
+    MultiChannelVolume filtered_planar(3, ChannelLayout::planar);
+    execute_multichannel_convolution(pool, rgb, filtered, per_channel, "RGB blur / Laplacian / z-edge");
+    execute_multichannel_convolution(pool, rgb_planar, filtered_planar, per_channel, "RGB blur / Laplacian / z-edge");
+    max_diff = 0.0f;
+    for (int c = 0; c < 3; ++c) {
+        for (size_t v = 0; v < VOLUME_SIZE; ++v) {
+            max_diff = std::max(max_diff, std::abs(filtered.data()[filtered.index(c, v)] -
+                                                   filtered_planar.data()[filtered_planar.index(c, v)]));
+        }
+    }
+    std::cout << "Interleaved vs. planar max |diff|: " << max_diff << std::endl;
+
+    // A blurred luminance channel mixed from all three inputs
+    std::vector<std::vector<float>> luminance_bank;
+    for (float weight : {0.299f, 0.587f, 0.114f}) {
+        std::vector<float> kernel(GAUSSIAN_BLUR);
+        for (float& w : kernel) {
+            w *= weight;
+        }
+        luminance_bank.push_back(std::move(kernel));
+    }
+    MultiChannelVolume luminance(1, ChannelLayout::planar);
+    execute_multichannel_convolution(pool, rgb_planar, luminance, ChannelKernels::cross_channel(1, 3, luminance_bank),
+                                     "Blurred luminance");
+    std::cout << "Luminance at the centre: "
+              << luminance.at(0, IMG_DEPTH / 2, IMG_HEIGHT / 2, IMG_WIDTH / 2) << std::endl;
+
+    // --- 15. Work-first octree reduction ---
+
+    // The same coroutine recursion on the default pool and on the lock-free variant
+    const VolumeSummary serial_summary = summarize_box(input_image, VoxelBox{0, IMG_DEPTH, 0, IMG_HEIGHT, 0, IMG_WIDTH});
+    const VolumeSummary octree_summary = execute_octree_summary(pool, input_image, "input volume, default pool");
+    VolumeSummary lock_free_summary;
+    {
+        ThroughputThreadPool variant_pool;
+        lock_free_summary = execute_octree_summary(variant_pool, input_image, "input volume, throughput pool");
+    }
+    std::cout << "Octree vs. serial max |sum diff|: "
+              << std::max(std::abs(octree_summary.sum - serial_summary.sum),
+                          std::abs(lock_free_summary.sum - serial_summary.sum))
+              << std::endl;
+
     std::cout << "\nAll filtering complete. The ThreadPool destructor will now run." << std::endl;
     
     return 0;
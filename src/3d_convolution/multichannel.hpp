@@ -0,0 +1,469 @@
+#ifndef __MULTICHANNEL_HPP__
+#define __MULTICHANNEL_HPP__
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "convolution.hpp"
+
+/**
+ * @file multichannel.hpp
+ * @brief Volumes with several channels per voxel, in interleaved or planar layout.
+ *
+ * Fluorescence stacks carry one channel per dye, diffusion data a vector or a
+ * tensor per voxel. Which layout suits depends on the consumer:
+ * - *planar* (structure of arrays): each channel is a complete volume, so
+ *   stencils along x read contiguous floats and SIMD lanes stay full; every
+ *   per-channel filter runs through `ConvolutionTask` with its specialised
+ *   dense, sparse and box paths;
+ * - *interleaved* (array of structures): the channels of a voxel are adjacent,
+ *   which suits consumers that gather whole voxels (rendering, per-voxel
+ *   eigen-decompositions) at the price of strided stencil accesses.
+ *
+ * @details
+ * - `convert_layout` re-arranges a volume on the pool, one task per z-slice.
+ * - `ChannelKernels` describes either one kernel per channel, or a bank of
+ *   cross-channel kernels where output channel o is the sum over input
+ *   channels i of input i convolved with kernel (o, i), e.g. a filtered
+ *   luminance from RGB.
+ * - `execute_multichannel_convolution` runs either on the pool; outputs cover
+ *   every voxel (zero borders), like `execute_convolution`.
+ *
+ * @author dssregi
+ * @version 1.0
+ * @date 2025-11-14
+ */
+
+/**
+ * @brief Memory layout of a multi-channel volume.
+ */
+enum class ChannelLayout {
+    interleaved,    ///< Array of structures: index = voxel * channels + channel.
+    planar          ///< Structure of arrays: index = channel * VOLUME_SIZE + voxel.
+};
+
+/**
+ * @brief Name of a layout, for reports.
+ */
+inline const char* to_string(ChannelLayout layout) {
+    return layout == ChannelLayout::planar ? "planar" : "interleaved";
+}
+
+/**
+ * @brief A `VOLUME_SIZE`-voxel volume with `channels` floats per voxel.
+ *
+ * Voxels are numbered like `Image` (z * W * H + y * W + x). The buffer starts
+ * out zeroed.
+ */
+class MultiChannelVolume {
+private:
+    int channels_;
+    ChannelLayout layout_;
+
+    /**
+     * @brief All channels, laid out according to `layout_`.
+     */
+    Image data_;
+
+public:
+    /**
+     * @brief Allocate a volume of @p channels channels in @p layout.
+     *
+     * @throws std::invalid_argument if @p channels is not positive.
+     */
+    MultiChannelVolume(int channels, ChannelLayout layout)
+        : channels_(channels), layout_(layout)
+    {
+        if (channels <= 0) {
+            throw std::invalid_argument("MultiChannelVolume: at least one channel is needed");
+        }
+        data_.resize(static_cast<size_t>(channels) * VOLUME_SIZE);
+    }
+
+    int channels() const {
+        return channels_;
+    }
+
+    ChannelLayout layout() const {
+        return layout_;
+    }
+
+    /**
+     * @brief Distance in floats between consecutive voxels of one channel.
+     */
+    int voxel_stride() const {
+        return layout_ == ChannelLayout::planar ? 1 : channels_;
+    }
+
+    /**
+     * @brief Index of @p channel of voxel @p voxel in `data()`.
+     */
+    size_t index(int channel, size_t voxel) const {
+        return layout_ == ChannelLayout::planar ? static_cast<size_t>(channel) * VOLUME_SIZE + voxel
+                                                : voxel * channels_ + channel;
+    }
+
+    float& at(int channel, int z, int y, int x) {
+        return data_[index(channel, static_cast<size_t>(z) * IMG_WIDTH * IMG_HEIGHT + y * IMG_WIDTH + x)];
+    }
+
+    float at(int channel, int z, int y, int x) const {
+        return data_[index(channel, static_cast<size_t>(z) * IMG_WIDTH * IMG_HEIGHT + y * IMG_WIDTH + x)];
+    }
+
+    float* data() {
+        return data_.data();
+    }
+
+    const float* data() const {
+        return data_.data();
+    }
+};
+
+/**
+ * @brief How the kernels of a multi-channel convolution combine channels.
+ */
+enum class ChannelMixing {
+    per_channel,    ///< Output channel c is input channel c convolved with kernel c.
+    cross_channel   ///< Output channel o sums every input channel i convolved with kernel (o, i).
+};
+
+/**
+ * @brief The kernels of a multi-channel convolution.
+ */
+class ChannelKernels {
+private:
+    ChannelMixing mixing_;
+    int inputs_;
+    int outputs_;
+
+    /**
+     * @brief Per channel: one kernel per channel. Cross channel: `outputs_` x
+     *        `inputs_` kernels by output, then input; an empty kernel contributes nothing.
+     */
+    std::vector<std::vector<float>> kernels_;
+
+    ChannelKernels(ChannelMixing mixing, int inputs, int outputs, std::vector<std::vector<float>> kernels)
+        : mixing_(mixing), inputs_(inputs), outputs_(outputs), kernels_(std::move(kernels))
+    {
+        for (const std::vector<float>& kernel : kernels_) {
+            const bool absent = kernel.empty() && mixing == ChannelMixing::cross_channel;
+            if (!absent && kernel.size() != static_cast<size_t>(KernelStructure::TAPS)) {
+                throw std::invalid_argument("ChannelKernels: kernels must have KERNEL_DIM^3 weights");
+            }
+        }
+    }
+
+public:
+    /**
+     * @brief One kernel per channel; the volume's channel count must match.
+     *
+     * @throws std::invalid_argument if a kernel does not have `KERNEL_DIM`^3 weights.
+     */
+    static ChannelKernels per_channel(std::vector<std::vector<float>> kernels) {
+        const int channels = static_cast<int>(kernels.size());
+        return ChannelKernels(ChannelMixing::per_channel, channels, channels, std::move(kernels));
+    }
+
+    /**
+     * @brief A bank of @p outputs x @p inputs kernels, `kernels[o * inputs + i]`
+     *        mapping input channel i to output channel o.
+     *
+     * @throws std::invalid_argument if the bank does not hold outputs x inputs
+     *         kernels, or a non-empty kernel does not have `KERNEL_DIM`^3 weights.
+     */
+    static ChannelKernels cross_channel(int outputs, int inputs, std::vector<std::vector<float>> kernels) {
+        if (outputs <= 0 || inputs <= 0 || kernels.size() != static_cast<size_t>(outputs) * inputs) {
+            throw std::invalid_argument("ChannelKernels: a cross-channel bank needs outputs x inputs kernels");
+        }
+        return ChannelKernels(ChannelMixing::cross_channel, inputs, outputs, std::move(kernels));
+    }
+
+    ChannelMixing mixing() const {
+        return mixing_;
+    }
+
+    int inputs() const {
+        return inputs_;
+    }
+
+    int outputs() const {
+        return outputs_;
+    }
+
+    /**
+     * @brief Kernel applied to input channel @p input for output channel @p output
+     *        (empty if that pair does not contribute).
+     */
+    const std::vector<float>& kernel(int output, int input) const {
+        static const std::vector<float> none;
+        if (mixing_ == ChannelMixing::per_channel) {
+            return output == input ? kernels_[output] : none;
+        }
+        return kernels_[static_cast<size_t>(output) * inputs_ + input];
+    }
+};
+
+/**
+ * @brief Re-arranges z-slices of one multi-channel volume into another's layout.
+ */
+class LayoutConversionTask {
+private:
+    const MultiChannelVolume& input_;
+    MultiChannelVolume& output_;
+
+public:
+    LayoutConversionTask(const MultiChannelVolume& input, MultiChannelVolume& output)
+        : input_(input), output_(output)
+    {}
+
+    /**
+     * @brief Convert slice @p z.
+     *
+     * Loops run along the output, so every write is sequential: channel-major
+     * into a planar output, voxel-major into an interleaved one.
+     */
+    void operator()(int z) const {
+        constexpr size_t SLICE_VOXELS = static_cast<size_t>(IMG_WIDTH) * IMG_HEIGHT;
+        const int channels = input_.channels();
+        const size_t first = static_cast<size_t>(z) * SLICE_VOXELS;
+        const float* in = input_.data();
+        float* out = output_.data();
+
+        if (input_.layout() == output_.layout()) {
+            for (int c = 0; c < (output_.layout() == ChannelLayout::planar ? channels : 1); ++c) {
+                const size_t begin = output_.index(c, first);
+                const size_t count = output_.layout() == ChannelLayout::planar ? SLICE_VOXELS : SLICE_VOXELS * channels;
+                std::copy_n(in + begin, count, out + begin);
+            }
+        } else if (output_.layout() == ChannelLayout::planar) {
+            for (int c = 0; c < channels; ++c) {
+                const float* src = in + input_.index(c, first);
+                float* dst = out + output_.index(c, first);
+                for (size_t v = 0; v < SLICE_VOXELS; ++v) {
+                    dst[v] = src[v * channels];
+                }
+            }
+        } else {
+            const float* src = in + input_.index(0, first);
+            float* dst = out + output_.index(0, first);
+            for (size_t v = 0; v < SLICE_VOXELS; ++v) {
+                for (int c = 0; c < channels; ++c) {
+                    dst[v * channels + c] = src[c * static_cast<size_t>(VOLUME_SIZE) + v];
+                }
+            }
+        }
+    }
+};
+
+/**
+ * @brief Copy @p input into @p output, converting between layouts, on the pool.
+ *
+ * @throws std::invalid_argument if the channel counts differ.
+ */
+inline void convert_layout(ThreadPool& pool, const MultiChannelVolume& input, MultiChannelVolume& output) {
+    if (input.channels() != output.channels()) {
+        throw std::invalid_argument("convert_layout: channel counts differ");
+    }
+    static const TaskTag convert_tag("LayoutConversionTask range");
+    HeartbeatOptions options;
+    options.tag = &convert_tag;
+
+    const LayoutConversionTask task(input, output);
+    heartbeat_for(pool, 0, IMG_DEPTH, [&task](long z) {
+        task(static_cast<int>(z));
+    }, options);
+}
+
+/**
+ * @brief Convolves z-slices of a multi-channel volume with strided accesses.
+ *
+ * Used for interleaved volumes and for cross-channel kernels; planar
+ * per-channel filtering goes through `ConvolutionTask` instead. Each kernel is
+ * reduced to its non-zero taps, and each output row is accumulated along x,
+ * one tap at a time, over every contributing input channel.
+ */
+class MultiChannelConvolutionTask {
+public:
+    /**
+     * @brief A non-zero tap: offset in voxels from the output voxel, and weight.
+     */
+    struct Tap {
+        int offset;
+        float weight;
+    };
+
+private:
+    const MultiChannelVolume& input_;
+    MultiChannelVolume& output_;
+
+    /**
+     * @brief Non-zero taps by output channel, then input channel.
+     */
+    const std::vector<std::vector<std::vector<Tap>>>& taps_;
+
+    /**
+     * @brief Zero the non-interior voxels of slice @p z in every output channel.
+     */
+    void zero_slice_border(int z) const {
+        for (int o = 0; o < output_.channels(); ++o) {
+            for (int r = 0; r < IMG_HEIGHT; ++r) {
+                for (int c = 0; c < IMG_WIDTH; ++c) {
+                    const bool interior = r >= BORDER && r < IMG_HEIGHT - BORDER && c >= BORDER && c < IMG_WIDTH - BORDER;
+                    if (!interior) {
+                        output_.at(o, z, r, c) = 0.0f;
+                    }
+                }
+            }
+        }
+    }
+
+public:
+    MultiChannelConvolutionTask(const MultiChannelVolume& input, MultiChannelVolume& output,
+                                const std::vector<std::vector<std::vector<Tap>>>& taps)
+        : input_(input), output_(output), taps_(taps)
+    {}
+
+    /**
+     * @brief Non-zero taps of every (output, input) kernel pair of @p kernels.
+     */
+    static std::vector<std::vector<std::vector<Tap>>> collect_taps(const ChannelKernels& kernels) {
+        std::vector<std::vector<std::vector<Tap>>> taps(kernels.outputs(),
+                                                         std::vector<std::vector<Tap>>(kernels.inputs()));
+        for (int o = 0; o < kernels.outputs(); ++o) {
+            for (int i = 0; i < kernels.inputs(); ++i) {
+                const std::vector<float>& kernel = kernels.kernel(o, i);
+                for (int k = 0; k < static_cast<int>(kernel.size()); ++k) {
+                    if (kernel[k] != 0.0f) {
+                        const int dz = k / (KERNEL_DIM * KERNEL_DIM) - BORDER;
+                        const int dy = k / KERNEL_DIM % KERNEL_DIM - BORDER;
+                        const int dx = k % KERNEL_DIM - BORDER;
+                        taps[o][i].push_back(Tap{(dz * IMG_HEIGHT + dy) * IMG_WIDTH + dx, kernel[k]});
+                    }
+                }
+            }
+        }
+        return taps;
+    }
+
+    /**
+     * @brief Compute slice @p z of every output channel (border planes included
+     *        when @p z is the first or last interior slice).
+     */
+    void operator()(int z) const {
+        constexpr int INTERIOR_WIDTH = IMG_WIDTH - 2 * BORDER;
+        const float* in = input_.data();
+        float* out = output_.data();
+        const size_t in_stride = input_.voxel_stride();
+        const size_t out_stride = output_.voxel_stride();
+
+        // Border planes belong to the slices at either end of the volume
+        const int border_plane = z == BORDER ? 0 : z == IMG_DEPTH - BORDER - 1 ? IMG_DEPTH - BORDER : -1;
+        if (border_plane >= 0) {
+            for (int p = border_plane; p < border_plane + BORDER; ++p) {
+                for (int o = 0; o < output_.channels(); ++o) {
+                    for (int r = 0; r < IMG_HEIGHT; ++r) {
+                        for (int c = 0; c < IMG_WIDTH; ++c) {
+                            output_.at(o, p, r, c) = 0.0f;
+                        }
+                    }
+                }
+            }
+        }
+        zero_slice_border(z);
+
+        for (int r = BORDER; r < IMG_HEIGHT - BORDER; ++r) {
+            const long row = static_cast<long>(z) * IMG_WIDTH * IMG_HEIGHT + r * IMG_WIDTH + BORDER;
+            for (int o = 0; o < output_.channels(); ++o) {
+                float acc[INTERIOR_WIDTH] = {};
+                for (int i = 0; i < input_.channels(); ++i) {
+                    for (const Tap& tap : taps_[o][i]) {
+                        const float* src = in + input_.index(i, static_cast<size_t>(row + tap.offset));
+                        for (int c = 0; c < INTERIOR_WIDTH; ++c) {
+                            acc[c] += src[c * in_stride] * tap.weight;
+                        }
+                    }
+                }
+                float* dst = out + output_.index(o, static_cast<size_t>(row));
+                for (int c = 0; c < INTERIOR_WIDTH; ++c) {
+                    dst[c * out_stride] = acc[c];
+                }
+            }
+        }
+    }
+};
+
+/**
+ * @brief Convolve a multi-channel volume with per-channel or cross-channel kernels.
+ *
+ * @param pool Reference to the ThreadPool for parallel execution.
+ * @param input The input volume; its channel count must match `kernels.inputs()`.
+ * @param[out] output Receives `kernels.outputs()` channels, in its own layout.
+ * @param kernels The kernels and how they combine channels.
+ * @param kernel_name Descriptive name of the filter (for logging).
+ *
+ * @details
+ * - Planar input and output with per-channel kernels: every channel is a
+ *   separate `ConvolutionTask` run (with its kernel's specialised code path),
+ *   all channels' slice ranges sharing one heartbeat loop.
+ * - Otherwise: one `MultiChannelConvolutionTask` per slice, which reads and
+ *   writes with the layouts' strides.
+ *
+ * @throws std::invalid_argument if the channel counts do not match the kernels.
+ */
+inline void execute_multichannel_convolution(ThreadPool& pool, const MultiChannelVolume& input,
+                                             MultiChannelVolume& output, const ChannelKernels& kernels,
+                                             const std::string& kernel_name)
+{
+    if (input.channels() != kernels.inputs() || output.channels() != kernels.outputs()) {
+        throw std::invalid_argument("execute_multichannel_convolution: channel counts do not match the kernels");
+    }
+    static const TaskTag channel_tag("Multi-channel convolution range");
+    HeartbeatOptions options;
+    options.tag = &channel_tag;
+
+    const int processable_slices = IMG_DEPTH - 2 * BORDER;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    const bool planar = input.layout() == ChannelLayout::planar && output.layout() == ChannelLayout::planar;
+    if (planar && kernels.mixing() == ChannelMixing::per_channel) {
+        std::vector<KernelStructure> structures;
+        for (int c = 0; c < kernels.outputs(); ++c) {
+            structures.push_back(KernelStructure::analyse(kernels.kernel(c, c)));
+        }
+        ShardedCounter completed_slices(pool);
+
+        // Iterations enumerate (channel, slice range) pairs, channel-major
+        const int grain = ConvolutionTask::slice_grain(pool.size());
+        const int ranges = (processable_slices + grain - 1) / grain;
+        heartbeat_for(pool, 0, static_cast<long>(kernels.outputs()) * ranges, [&](long n) {
+            const int c = static_cast<int>(n / ranges);
+            const int z = BORDER + static_cast<int>(n % ranges) * grain;
+            ConvolutionTask(input.data() + input.index(c, 0), output.data() + output.index(c, 0),
+                            kernels.kernel(c, c), structures[c], z, std::min(z + grain, IMG_DEPTH - BORDER),
+                            completed_slices)();
+        }, options);
+    } else {
+        const auto taps = MultiChannelConvolutionTask::collect_taps(kernels);
+        const MultiChannelConvolutionTask task(input, output, taps);
+        heartbeat_for(pool, BORDER, IMG_DEPTH - BORDER, [&task](long z) {
+            task(static_cast<int>(z));
+        }, options);
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+
+    std::cout << "\n[Filter: " << kernel_name << "] " << input.channels() << " " << to_string(input.layout())
+              << " -> " << output.channels() << " " << to_string(output.layout())
+              << (output.channels() == 1 ? " channel (" : " channels (")
+              << (kernels.mixing() == ChannelMixing::per_channel ? "per-channel" : "cross-channel")
+              << " kernels) in " << duration.count() << " us" << std::endl;
+}
+
+#endif // __MULTICHANNEL_HPP__
@@ -0,0 +1,154 @@
+#ifndef __OCTREE_REDUCTION_HPP__
+#define __OCTREE_REDUCTION_HPP__
+
+#include <vector>
+#include <chrono>
+#include <string>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <iostream>
+
+#include "convolution.hpp"
+#include "../core/work_first.hpp"
+
+/**
+ * @file octree_reduction.hpp
+ * @brief Whole-volume statistics by work-first octree recursion.
+ *
+ * The volume is split into octants until a box holds at most
+ * `OCTREE_LEAF_VOXELS` voxels; each level spawns seven octants work-first,
+ * runs the eighth as a call and joins. On an idle pool the recursion runs in
+ * serial depth-first order on one worker, and thieves take the parents'
+ * continuations (the remaining octants of the largest boxes) rather than
+ * individual leaves.
+ *
+ * @details
+ * - The recursion is templated on the pool variant, so the same code runs on
+ *   `ThreadPool` and on the lock-free `ThroughputThreadPool`.
+ * - Leaves are summed serially in z, y, x order; only the combination order of
+ *   the partial sums differs from a serial pass.
+ *
+ * @author dssregi
+ * @version 1.0
+ * @date 2025-11-14
+ */
+
+/**
+ * @brief Sum, extremes and voxel count of a region of a volume.
+ */
+struct VolumeSummary {
+    double sum = 0.0;
+    float min = std::numeric_limits<float>::infinity();
+    float max = -std::numeric_limits<float>::infinity();
+    size_t voxels = 0;
+
+    /**
+     * @brief Fold the summary of a disjoint region into this one.
+     */
+    void merge(const VolumeSummary& other) {
+        sum += other.sum;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+        voxels += other.voxels;
+    }
+};
+
+/**
+ * @brief Half-open box [z0, z1) x [y0, y1) x [x0, x1) of voxel coordinates.
+ */
+struct VoxelBox {
+    int z0, z1;
+    int y0, y1;
+    int x0, x1;
+
+    size_t voxels() const {
+        return static_cast<size_t>(z1 - z0) * static_cast<size_t>(y1 - y0) * static_cast<size_t>(x1 - x0);
+    }
+};
+
+/**
+ * @brief Largest box summarised serially instead of split further.
+ */
+inline constexpr size_t OCTREE_LEAF_VOXELS = 64;
+
+/**
+ * @brief Summarise @p box of @p volume serially.
+ */
+inline VolumeSummary summarize_box(const Image& volume, const VoxelBox& box) {
+    VolumeSummary summary;
+    for (int z = box.z0; z < box.z1; ++z) {
+        for (int y = box.y0; y < box.y1; ++y) {
+            const float* row = &volume[(static_cast<size_t>(z) * IMG_HEIGHT + y) * IMG_WIDTH];
+            for (int x = box.x0; x < box.x1; ++x) {
+                summary.sum += row[x];
+                summary.min = std::min(summary.min, row[x]);
+                summary.max = std::max(summary.max, row[x]);
+            }
+        }
+    }
+    summary.voxels = box.voxels();
+    return summary;
+}
+
+/**
+ * @brief Summarise @p box of @p volume by recursive octant splitting.
+ *
+ * Axes of extent one are not split, so a box has up to eight octants.
+ *
+ * @tparam Pool Pool variant the recursion runs on.
+ */
+template <class Pool>
+WorkFirstTask<VolumeSummary, Pool> summarize_octree(const Image& volume, VoxelBox box) {
+    if (box.voxels() <= OCTREE_LEAF_VOXELS) {
+        co_return summarize_box(volume, box);
+    }
+
+    const int zm = box.z1 - box.z0 > 1 ? (box.z0 + box.z1) / 2 : box.z1;
+    const int ym = box.y1 - box.y0 > 1 ? (box.y0 + box.y1) / 2 : box.y1;
+    const int xm = box.x1 - box.x0 > 1 ? (box.x0 + box.x1) / 2 : box.x1;
+
+    std::vector<WorkFirstTask<VolumeSummary, Pool>> octants;
+    octants.reserve(8);
+    for (auto [z0, z1] : {std::pair{box.z0, zm}, std::pair{zm, box.z1}}) {
+        for (auto [y0, y1] : {std::pair{box.y0, ym}, std::pair{ym, box.y1}}) {
+            for (auto [x0, x1] : {std::pair{box.x0, xm}, std::pair{xm, box.x1}}) {
+                if (z0 < z1 && y0 < y1 && x0 < x1) {
+                    octants.push_back(summarize_octree<Pool>(volume, VoxelBox{z0, z1, y0, y1, x0, x1}));
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i + 1 < octants.size(); ++i) {
+        co_await spawn(octants[i]);
+    }
+    VolumeSummary summary = co_await octants.back();
+    co_await join();
+
+    for (size_t i = 0; i + 1 < octants.size(); ++i) {
+        summary.merge(octants[i].get());
+    }
+    co_return summary;
+}
+
+/**
+ * @brief Summarise the whole of @p volume on @p pool and print the result.
+ *
+ * Must be called from a thread that is not a worker of @p pool.
+ *
+ * @return The summary of every voxel.
+ */
+template <class Pool>
+VolumeSummary execute_octree_summary(Pool& pool, const Image& volume, const std::string& label) {
+    auto start = std::chrono::steady_clock::now();
+    VolumeSummary summary = sync_wait(pool, summarize_octree<Pool>(volume, VoxelBox{0, IMG_DEPTH, 0, IMG_HEIGHT, 0, IMG_WIDTH}));
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    std::cout << "\n[Octree: " << label << "] " << summary.voxels << " voxels, mean "
+              << summary.sum / static_cast<double>(summary.voxels) << ", range [" << summary.min << ", "
+              << summary.max << "] in " << duration.count() << " us" << std::endl;
+    return summary;
+}
+
+#endif // __OCTREE_REDUCTION_HPP__
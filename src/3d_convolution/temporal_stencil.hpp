@@ -0,0 +1,358 @@
+#ifndef __TEMPORAL_STENCIL_HPP__
+#define __TEMPORAL_STENCIL_HPP__
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <iostream>
+
+#include "convolution.hpp"
+
+/**
+ * @file temporal_stencil.hpp
+ * @brief Temporal blocking for repeated 3D stencil application.
+ *
+ * Applying a 3x3x3 kernel N times with `execute_convolution` streams the whole
+ * volume through memory N times. This engine instead advances a tile of
+ * z-slices by several time steps while it is cache resident, using split
+ * (trapezoid) tiling along z:
+ *
+ * @details
+ * - Time is cut into blocks of T steps. Within a block, each *upright* tile
+ *   [a, b) computes step t on [a + t, b - t): it shrinks by one slice per step
+ *   on every side that touches another tile, so it only needs data it produced
+ *   itself. Upright tiles of a block are independent of each other.
+ * - Each *inverted* tile, centred on the boundary b between two upright tiles,
+ *   computes step t on [b - t, b + t), filling the wedges the upright tiles left
+ *   out. It depends on its two neighbouring upright tiles, and the next block's
+ *   upright tiles depend on the inverted tiles around them.
+ * - Tiles are intrusive tasks with dependency counters; a finishing tile
+ *   submits every successor whose counter drops to zero, so the pool's
+ *   work stealing balances the wavefront.
+ * - Two buffers are used in ping-pong order by step parity. Each step zeroes the
+ *   border voxels of the slices it computes (and the tiles at either end the
+ *   border planes), so the result is identical to calling `execute_convolution`
+ *   N times and neither buffer needs clearing first.
+ *
+ * @author dssregi
+ * @version 1.0
+ * @date 2025-11-14
+ */
+
+/**
+ * @brief Tiling parameters of `execute_temporal_convolution`.
+ */
+struct TemporalBlockingOptions {
+    /**
+     * @brief Time steps applied per tile before moving on (T).
+     */
+    int time_block = 4;
+
+    /**
+     * @brief Minimum number of z-slices per upright tile; raised to 2T + 2 if smaller.
+     */
+    int tile_slices = 0;
+};
+
+/**
+ * @brief Task graph of one temporally blocked stencil run.
+ *
+ * @thread_safety `run` must be called once, from outside the pool (it blocks
+ *                until every tile has executed).
+ */
+class TemporalStencil {
+private:
+    /**
+     * @brief One trapezoid of one time block, linked into the pool as an intrusive task.
+     */
+    struct Tile final : IntrusiveTask {
+        TemporalStencil* engine = nullptr;
+        int block = 0;          ///< Time block index.
+        int index = 0;          ///< Upright tile index, or boundary index for inverted tiles.
+        bool inverted = false;  ///< Inverted (growing) trapezoid.
+
+        /**
+         * @brief Predecessors still to finish.
+         */
+        std::atomic<int> pending{0};
+
+        void execute() override {
+            engine->run_tile(*this);
+        }
+    };
+
+    ThreadPool& pool_;
+    const Image& input_;
+    Image& output_;
+    const std::vector<float>& kernel_;
+    const KernelStructure structure_;
+
+    /**
+     * @brief Odd-parity partner of `output_` in the ping-pong scheme.
+     */
+    Image scratch_;
+
+    /**
+     * @brief Total number of time steps (N).
+     */
+    const int iterations_;
+
+    /**
+     * @brief Time steps per block (T).
+     */
+    int time_block_ = 1;
+
+    /**
+     * @brief Number of time blocks.
+     */
+    int blocks_ = 0;
+
+    /**
+     * @brief Number of upright tiles per block (n); there are n - 1 inverted tiles.
+     */
+    int tiles_ = 1;
+
+    /**
+     * @brief Upright tile boundaries along z (n + 1 entries).
+     */
+    std::vector<int> bounds_;
+
+    /**
+     * @brief All tiles, block-major: n upright followed by n - 1 inverted.
+     */
+    std::unique_ptr<Tile[]> graph_;
+
+    /**
+     * @brief Slice updates performed (one per slice per step).
+     */
+    ShardedCounter slice_updates_;
+
+    /**
+     * @brief Completion tracking for `run`.
+     */
+    std::mutex done_mut_;
+    std::condition_variable done_cv_;
+    int remaining_ = 0;
+
+    Tile& upright(int block, int i) {
+        return graph_[block * (2 * tiles_ - 1) + i];
+    }
+
+    Tile& inverted(int block, int i) {
+        return graph_[block * (2 * tiles_ - 1) + tiles_ + i];
+    }
+
+    /**
+     * @brief Buffer holding time step @p step (the last step lands in `output_`).
+     */
+    Image& buffer(int step) {
+        return (iterations_ - step) % 2 == 0 ? output_ : scratch_;
+    }
+
+    /**
+     * @brief Volume to read step @p step from (step 0 is the input).
+     */
+    const Image& source(int step) {
+        return step == 0 ? input_ : buffer(step);
+    }
+
+    /**
+     * @brief Compute time step @p step on slices [lo, hi).
+     */
+    void compute(int step, int lo, int hi) {
+        if (lo < hi) {
+            ConvolutionTask(source(step - 1), buffer(step), kernel_, structure_, lo, hi, slice_updates_)();
+        }
+    }
+
+    /**
+     * @brief Decrement @p tile's dependency counter, submitting it once ready.
+     */
+    void release(Tile& tile) {
+        if (tile.pending.fetch_sub(1) == 1) {
+            pool_.submit(tile);
+        }
+    }
+
+    /**
+     * @brief Execute one trapezoid and release its successors.
+     */
+    void run_tile(Tile& tile) {
+        const int base = tile.block * time_block_;
+        const int steps = std::min(time_block_, iterations_ - base);
+        const int k = tile.block;
+        const int i = tile.index;
+
+        if (!tile.inverted) {
+            // Shrink only on sides that border another tile
+            const int shrink_lo = i > 0 ? 1 : 0;
+            const int shrink_hi = i < tiles_ - 1 ? 1 : 0;
+            for (int t = 1; t <= steps; ++t) {
+                compute(base + t, bounds_[i] + shrink_lo * t, bounds_[i + 1] - shrink_hi * t);
+            }
+
+            if (tiles_ == 1) {
+                if (k + 1 < blocks_) {
+                    release(upright(k + 1, i));
+                }
+            } else {
+                if (i > 0) {
+                    release(inverted(k, i - 1));
+                }
+                if (i < tiles_ - 1) {
+                    release(inverted(k, i));
+                }
+            }
+        } else {
+            const int b = bounds_[i + 1];
+            for (int t = 1; t <= steps; ++t) {
+                compute(base + t, b - t, b + t);
+            }
+
+            if (k + 1 < blocks_) {
+                release(upright(k + 1, i));
+                release(upright(k + 1, i + 1));
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(done_mut_);
+        if (--remaining_ == 0) {
+            done_cv_.notify_all();
+        }
+    }
+
+public:
+    /**
+     * @brief Build the tile graph for @p iterations applications of @p kernel.
+     *
+     * @param pool Pool that executes the tiles.
+     * @param input The input 3D volume (const reference).
+     * @param[out] output Result of the last iteration.
+     * @param kernel The convolution kernel: 27 floats for 3x3x3 (const reference).
+     * @param iterations Number of times the kernel is applied.
+     * @param options Time block length and tile width.
+     */
+    TemporalStencil(ThreadPool& pool, const Image& input, Image& output, const std::vector<float>& kernel,
+                    int iterations, TemporalBlockingOptions options = {})
+        : pool_(pool), input_(input), output_(output), kernel_(kernel),
+          structure_(KernelStructure::analyse(kernel)), scratch_(VOLUME_SIZE, UNINITIALISED_VOXELS), iterations_(std::max(0, iterations)), slice_updates_(pool)
+    {
+        const int first = BORDER;
+        const int slices = IMG_DEPTH - 2 * BORDER;
+
+        time_block_ = std::max(1, options.time_block);
+        blocks_ = (iterations_ + time_block_ - 1) / time_block_;
+
+        // Neighbouring inverted tiles (2T wide) and their halos must not overlap
+        const int width = std::max(options.tile_slices, 2 * time_block_ + 2);
+        tiles_ = std::max(1, slices / width);
+        for (int i = 0; i <= tiles_; ++i) {
+            bounds_.push_back(first + slices * i / tiles_);
+        }
+
+        const int per_block = 2 * tiles_ - 1;
+        graph_ = std::make_unique<Tile[]>(static_cast<size_t>(blocks_) * per_block);
+        remaining_ = blocks_ * per_block;
+
+        for (int k = 0; k < blocks_; ++k) {
+            for (int i = 0; i < tiles_; ++i) {
+                Tile& u = upright(k, i);
+                u.engine = this;
+                u.block = k;
+                u.index = i;
+                int deps = 0;
+                if (k > 0) {
+                    deps = tiles_ == 1 ? 1 : (i > 0) + (i < tiles_ - 1);
+                }
+                u.pending.store(deps, std::memory_order_relaxed);
+            }
+            for (int i = 0; i + 1 < tiles_; ++i) {
+                Tile& v = inverted(k, i);
+                v.engine = this;
+                v.block = k;
+                v.index = i;
+                v.inverted = true;
+                v.pending.store(2, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Execute every tile on the pool and wait for the last one.
+     */
+    void run() {
+        // Every step writes whole slices of its buffer, borders included
+        if (blocks_ == 0) {
+            output_ = input_;
+            return;
+        }
+
+        static const TaskTag tile_tag("TemporalStencil tile");
+        for (int i = 0; i < tiles_; ++i) {
+            pool_.submit(upright(0, i), tile_tag);
+        }
+
+        std::unique_lock<std::mutex> lock(done_mut_);
+        done_cv_.wait(lock, [this] { return remaining_ == 0; });
+    }
+
+    /**
+     * @brief Number of upright tiles per time block.
+     */
+    int tiles() const {
+        return tiles_;
+    }
+
+    /**
+     * @brief Time steps per block.
+     */
+    int time_block() const {
+        return time_block_;
+    }
+
+    /**
+     * @brief Slice updates performed so far (N x interior slices once `run` returns).
+     */
+    long slice_updates() const {
+        return slice_updates_.sum();
+    }
+};
+
+/**
+ * @brief Apply a kernel @p iterations times with temporal blocking.
+ *
+ * Same result as calling `execute_convolution` @p iterations times, feeding each
+ * output back as the next input, but each tile of slices is advanced
+ * `options.time_block` steps while it is cache resident.
+ *
+ * @param pool Reference to the ThreadPool for parallel execution (call from outside it).
+ * @param input The input 3D volume (const reference).
+ * @param[out] output Result of the last iteration (border voxels are zero).
+ * @param kernel The convolution kernel: 27 floats for 3x3x3 (const reference).
+ * @param kernel_name Descriptive name of the kernel (for logging).
+ * @param iterations Number of times the kernel is applied.
+ * @param options Time block length and tile width.
+ */
+inline void execute_temporal_convolution(ThreadPool& pool, const Image& input, Image& output,
+                                         const std::vector<float>& kernel, const std::string& kernel_name,
+                                         int iterations, TemporalBlockingOptions options = {})
+{
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    TemporalStencil stencil(pool, input, output, kernel, iterations, options);
+    stencil.run();
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+
+    std::cout << "\n[Filter: " << kernel_name << "] " << iterations << " iterations in time blocks of "
+              << stencil.time_block() << " over " << stencil.tiles() << " z-tiles ("
+              << stencil.slice_updates() << " slice updates) in " << duration.count() << " us" << std::endl;
+}
+
+#endif // __TEMPORAL_STENCIL_HPP__
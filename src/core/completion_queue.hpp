@@ -0,0 +1,232 @@
+#ifndef __COMPLETION_QUEUE_HPP__
+#define __COMPLETION_QUEUE_HPP__
+
+#include <atomic>
+#include <vector>
+#include <utility>
+#include <chrono>
+#include <thread>
+#include <cerrno>
+#include <system_error>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "thread_pool.hpp"
+
+/**
+ * @file completion_queue.hpp
+ * @brief Hand results from pool tasks back to an external event loop.
+ *
+ * An epoll (or poll/select) loop that offloads work to the pool cannot block on
+ * a future without stalling its other descriptors. A `CompletionQueue<T>` owns
+ * an eventfd the loop registers like any socket: tasks push results, the
+ * descriptor becomes readable, and the loop drains every queued result at once.
+ *
+ * @details
+ * - Results go onto a lock-free multi-producer, single-consumer stack; the
+ *   consumer takes the whole stack with one exchange and reverses it, so a
+ *   drain costs one atomic operation however many results it returns.
+ * - Eventfd writes are coalesced: only the producer that finds the queue
+ *   unsignalled writes, so a burst of results costs one system call on the
+ *   producer side and one wake-up of the loop.
+ *
+ * @author dssregi
+ * @version 1.0
+ * @date 2025-11-14
+ */
+
+/**
+ * @brief MPSC result queue signalled through an eventfd.
+ *
+ * @tparam T Result type (movable).
+ *
+ * @thread_safety `push` may be called from any number of threads; `drain`,
+ *                `wait_for` and the descriptor's readiness belong to one
+ *                consumer thread.
+ */
+template <class T>
+class CompletionQueue {
+private:
+    /**
+     * @brief Stack node holding one result.
+     */
+    struct Node {
+        T value;
+        Node* next;
+    };
+
+    /**
+     * @brief Most recently pushed node (LIFO order until drained).
+     */
+    std::atomic<Node*> head_{nullptr};
+
+    /**
+     * @brief Set by the producer that wrote the eventfd; cleared by the consumer.
+     */
+    std::atomic<bool> signalled_{false};
+
+    /**
+     * @brief Producers inside `push`.
+     *
+     * The consumer may see a result before its producer has finished signalling,
+     * so the destructor waits for this to drop to zero.
+     */
+    std::atomic<int> pushing_{0};
+
+    /**
+     * @brief Non-blocking eventfd the consumer waits on.
+     */
+    int fd_;
+
+    /**
+     * @brief Take every queued node, oldest first.
+     */
+    Node* take_all() {
+        // Clear the descriptor before the flag, and the flag before taking the
+        // stack: a result pushed after the exchange finds the flag clear and
+        // signals again, so it cannot be stranded without a wake-up. The
+        // exchange releases the cleared flag to the producer whose CAS reads
+        // the emptied stack.
+        uint64_t count = 0;
+        [[maybe_unused]] ssize_t n = ::read(fd_, &count, sizeof(count));
+        signalled_.store(false);
+
+        Node* node = head_.exchange(nullptr, std::memory_order_acq_rel);
+        Node* fifo = nullptr;
+        while (node != nullptr) {
+            Node* next = node->next;
+            node->next = fifo;
+            fifo = node;
+            node = next;
+        }
+        return fifo;
+    }
+
+public:
+    /**
+     * @brief Create the queue and its eventfd.
+     *
+     * @throws std::system_error if the eventfd cannot be created.
+     */
+    CompletionQueue() : fd_(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {
+        if (fd_ < 0) {
+            throw std::system_error(errno, std::system_category(), "eventfd");
+        }
+    }
+
+    /**
+     * @brief Wait for `push` calls in progress, destroy undrained results and
+     *        close the eventfd.
+     *
+     * Tasks that have not started pushing yet must not outlive the queue.
+     */
+    ~CompletionQueue() {
+        while (pushing_.load(std::memory_order_acquire) != 0) {
+            std::this_thread::yield();
+        }
+
+        Node* node = head_.load(std::memory_order_acquire);
+        while (node != nullptr) {
+            Node* next = node->next;
+            delete node;
+            node = next;
+        }
+        ::close(fd_);
+    }
+
+    /**
+     * @brief Disable copy construction.
+     */
+    CompletionQueue(const CompletionQueue&) = delete;
+
+    /**
+     * @brief Disable copy assignment.
+     */
+    CompletionQueue& operator =(const CompletionQueue&) = delete;
+
+    /**
+     * @brief Descriptor to register with epoll/poll for `EPOLLIN`.
+     */
+    int fd() const {
+        return fd_;
+    }
+
+    /**
+     * @brief Queue a result and signal the consumer if it has not been yet.
+     */
+    void push(T value) {
+        pushing_.fetch_add(1);
+        Node* node = new Node{std::move(value), head_.load(std::memory_order_relaxed)};
+        // Acquire pairs with the consumer's exchange: a push landing on a stack it
+        // emptied sees its cleared flag below
+        while (!head_.compare_exchange_weak(node->next, node, std::memory_order_acq_rel,
+                                            std::memory_order_relaxed)) {
+        }
+
+        if (!signalled_.exchange(true)) {
+            const uint64_t one = 1;
+            [[maybe_unused]] ssize_t n = ::write(fd_, &one, sizeof(one));
+        }
+        pushing_.fetch_sub(1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Hand every queued result to @p consume, in push order per producer.
+     *
+     * Also resets the descriptor's readiness. Call it whenever the descriptor
+     * is readable; a wake-up may occasionally find nothing to drain.
+     *
+     * @param consume Called as `consume(T&&)` for each result.
+     * @return Number of results consumed.
+     */
+    template <class F>
+    size_t drain(F&& consume) {
+        size_t count = 0;
+        for (Node* node = take_all(); node != nullptr; ++count) {
+            Node* next = node->next;
+            consume(std::move(node->value));
+            delete node;
+            node = next;
+        }
+        return count;
+    }
+
+    /**
+     * @brief Append every queued result to @p out.
+     *
+     * @return Number of results appended.
+     */
+    size_t drain(std::vector<T>& out) {
+        return drain([&out](T&& value) { out.push_back(std::move(value)); });
+    }
+
+    /**
+     * @brief Block until the descriptor is readable or @p timeout elapses.
+     *
+     * Convenience for consumers without an event loop of their own.
+     *
+     * @return true if results may be available.
+     */
+    bool wait_for(std::chrono::milliseconds timeout) {
+        pollfd pfd{fd_, POLLIN, 0};
+        return ::poll(&pfd, 1, static_cast<int>(timeout.count())) > 0;
+    }
+};
+
+/**
+ * @brief Run @p func on @p pool and push its result onto @p queue.
+ *
+ * @param pool Pool executing the task (any `BasicThreadPool` variant).
+ * @param queue Queue receiving the result; must outlive the task.
+ * @param func Copyable callable returning a value convertible to `T`.
+ */
+template <class Pool, class T, class F>
+void submit_to(Pool& pool, CompletionQueue<T>& queue, F func) {
+    pool.submit([&queue, func = std::move(func)]() mutable {
+        queue.push(func());
+    });
+}
+
+#endif // __COMPLETION_QUEUE_HPP__
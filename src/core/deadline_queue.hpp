@@ -0,0 +1,246 @@
+#ifndef __DEADLINE_QUEUE_HPP__
+#define __DEADLINE_QUEUE_HPP__
+
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <cstdint>
+#include <ostream>
+#include <algorithm>
+
+/**
+ * @file deadline_queue.hpp
+ * @brief Earliest-deadline-first queue and deadline-miss statistics.
+ *
+ * Tasks of the pool's deadline scheduling class carry an absolute deadline and
+ * are kept in a per-worker min-heap keyed by that deadline, so both the owner
+ * and thieves always take the most urgent entry. The earliest deadline is also
+ * published in an atomic, letting thieves compare victims without locking.
+ *
+ * @author dssregi
+ * @version 1.0
+ * @date 2025-11-14
+ */
+
+/**
+ * @brief Thread-safe min-heap of values ordered by absolute deadline.
+ *
+ * @tparam T Type of the stored values (MoveConstructible).
+ *
+ * @details
+ * Entries with equal deadlines are served in submission order. Unbounded and
+ * non-blocking; the pool wakes parked workers itself.
+ *
+ * @thread_safety All operations are safe for concurrent use and serialized by
+ *                an internal mutex; `earliest()` and `empty()` are lock-free reads.
+ */
+template <class T>
+class DeadlineQueue {
+public:
+    /**
+     * @brief Clock deadlines are expressed in.
+     */
+    using Clock = std::chrono::steady_clock;
+
+private:
+    /**
+     * @brief Heap entry.
+     */
+    struct Entry {
+        Clock::time_point deadline;
+        uint64_t seq;   ///< Submission order, breaks deadline ties FIFO.
+        T value;
+    };
+
+    /**
+     * @brief Heap order: the entry with the earliest deadline sits at the front.
+     */
+    static bool later(const Entry& a, const Entry& b) {
+        return a.deadline != b.deadline ? a.deadline > b.deadline : a.seq > b.seq;
+    }
+
+    /**
+     * @brief Mutex protecting the heap.
+     */
+    std::mutex mut_;
+
+    /**
+     * @brief Binary min-heap of entries (ordered with `later`).
+     */
+    std::vector<Entry> heap_;
+
+    /**
+     * @brief Next submission sequence number.
+     */
+    uint64_t next_seq_ = 0;
+
+    /**
+     * @brief Earliest queued deadline in clock ticks, or the maximum value when empty.
+     */
+    std::atomic<Clock::rep> earliest_{std::numeric_limits<Clock::rep>::max()};
+
+    /**
+     * @brief Republish the head deadline (lock held).
+     */
+    void publish() {
+        earliest_.store(heap_.empty() ? std::numeric_limits<Clock::rep>::max()
+                                      : heap_.front().deadline.time_since_epoch().count());
+    }
+
+public:
+    DeadlineQueue() = default;
+
+    /**
+     * @brief Disable copy construction.
+     */
+    DeadlineQueue(const DeadlineQueue&) = delete;
+
+    /**
+     * @brief Disable copy assignment.
+     */
+    DeadlineQueue& operator =(const DeadlineQueue&) = delete;
+
+    /**
+     * @brief Insert a value due by @p deadline.
+     */
+    void push(Clock::time_point deadline, T value) {
+        std::lock_guard<std::mutex> lock(mut_);
+        heap_.push_back(Entry{deadline, next_seq_++, std::move(value)});
+        std::push_heap(heap_.begin(), heap_.end(), later);
+        publish();
+    }
+
+    /**
+     * @brief Remove the value with the earliest deadline without blocking.
+     *
+     * Used by the owner and by thieves alike: EDF order is the same for both.
+     *
+     * @param[out] value Where the value is placed if the pop succeeds.
+     * @param[out] deadline Where its deadline is placed if the pop succeeds.
+     * @return true if a value was popped, false if the queue was empty.
+     */
+    bool try_pop(T& value, Clock::time_point& deadline) {
+        if (empty()) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mut_);
+        if (heap_.empty()) {
+            return false;
+        }
+
+        std::pop_heap(heap_.begin(), heap_.end(), later);
+        value = std::move(heap_.back().value);
+        deadline = heap_.back().deadline;
+        heap_.pop_back();
+        publish();
+        return true;
+    }
+
+    /**
+     * @brief Earliest queued deadline, read without locking (racy snapshot).
+     *
+     * @return The deadline, or `Clock::time_point::max()` if the queue is empty.
+     */
+    Clock::time_point earliest() const {
+        return Clock::time_point(Clock::duration(earliest_.load(std::memory_order_relaxed)));
+    }
+
+    /**
+     * @brief Lock-free emptiness check (sequentially consistent).
+     */
+    bool empty() const {
+        return earliest_.load() == std::numeric_limits<Clock::rep>::max();
+    }
+
+    /**
+     * @brief Number of queued values (for monitoring).
+     */
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mut_);
+        return heap_.size();
+    }
+};
+
+/**
+ * @brief Aggregated outcome of deadline-class tasks.
+ */
+struct DeadlineStats {
+    /**
+     * @brief Number of deadline tasks that have finished.
+     */
+    uint64_t completed = 0;
+
+    /**
+     * @brief Number of those that finished after their deadline.
+     */
+    uint64_t missed = 0;
+
+    /**
+     * @brief Mean lateness of the missed tasks, in nanoseconds.
+     */
+    double mean_lateness_ns = 0.0;
+
+    /**
+     * @brief Worst lateness observed, in nanoseconds.
+     */
+    uint64_t max_lateness_ns = 0;
+
+    /**
+     * @brief Fraction of completed tasks that missed their deadline.
+     */
+    double miss_rate() const {
+        return completed == 0 ? 0.0 : static_cast<double>(missed) / completed;
+    }
+};
+
+/**
+ * @brief Print a one-line summary of deadline outcomes.
+ */
+inline std::ostream& operator <<(std::ostream& os, const DeadlineStats& stats) {
+    return os << "Deadline tasks: " << stats.completed << " completed, " << stats.missed
+              << " missed (" << stats.miss_rate() * 100.0 << "%), mean lateness "
+              << stats.mean_lateness_ns / 1e6 << " ms, max lateness "
+              << stats.max_lateness_ns / 1e6 << " ms" << std::endl;
+}
+
+/**
+ * @brief Deadline outcome counters of one worker (single writer, padded).
+ */
+struct alignas(64) DeadlineCounters {
+    std::atomic<uint64_t> completed{0};
+    std::atomic<uint64_t> missed{0};
+    std::atomic<uint64_t> lateness_ns{0};      ///< Sum over missed tasks.
+    std::atomic<uint64_t> max_lateness_ns{0};
+
+    /**
+     * @brief Record one finished task (called by the owning worker only).
+     *
+     * @param late_ns Nanoseconds past the deadline, or 0 if it was met.
+     */
+    void record(uint64_t late_ns) {
+        completed.store(completed.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (late_ns == 0) {
+            return;
+        }
+        missed.store(missed.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        lateness_ns.store(lateness_ns.load(std::memory_order_relaxed) + late_ns, std::memory_order_relaxed);
+        if (late_ns > max_lateness_ns.load(std::memory_order_relaxed)) {
+            max_lateness_ns.store(late_ns, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Add these counters into @p stats (any thread).
+     */
+    void merge_into(DeadlineStats& stats, uint64_t& lateness_sum) const {
+        stats.completed += completed.load(std::memory_order_relaxed);
+        stats.missed += missed.load(std::memory_order_relaxed);
+        lateness_sum += lateness_ns.load(std::memory_order_relaxed);
+        stats.max_lateness_ns = std::max(stats.max_lateness_ns, max_lateness_ns.load(std::memory_order_relaxed));
+    }
+};
+
+#endif // __DEADLINE_QUEUE_HPP__
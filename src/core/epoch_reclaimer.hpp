@@ -0,0 +1,324 @@
+#ifndef __EPOCH_RECLAIMER_HPP__
+#define __EPOCH_RECLAIMER_HPP__
+
+#include <atomic>
+#include <vector>
+#include <mutex>
+#include <limits>
+#include <cstdint>
+#include <new>
+
+/**
+ * @file epoch_reclaimer.hpp
+ * @brief Epoch-based safe memory reclamation for the lock-free structures in `src/core`.
+ *
+ * A lock-free structure cannot free a node or buffer it has unlinked while another
+ * thread may still be reading it. With epoch-based reclamation (EBR), readers
+ * announce the global epoch they observed for the duration of a critical section
+ * (`pin()`), and writers *retire* unlinked memory instead of deleting it. Memory
+ * retired in epoch e is freed once the global epoch reaches e + 2, which can only
+ * happen after every thread that might hold a reference has left its critical section.
+ *
+ * @details
+ * - One process-wide `EpochReclaimer` is shared by all lock-free structures, so a
+ *   worker has a single epoch slot no matter how many structures it touches.
+ * - Each thread owns a cache-line-sized slot holding its announced epoch and its
+ *   private list of retired objects; retirement never takes a lock. Slots come
+ *   in blocks of `BLOCK_SLOTS`, chained on demand, so any number of threads
+ *   can participate at once.
+ * - Retired objects are freed in batches: the global epoch is only advanced (a
+ *   scan over all slots) once a thread has accumulated `BATCH` retirements.
+ * - Only code paths that *read shared memory owned by someone else* must pin.
+ *   Structures are expected to keep their owner fast paths pin-free, e.g. the
+ *   Chase-Lev deque only pins in `steal`, never in the owner's push/pop.
+ *   Structures whose nodes only ever have one reader at a time need no epochs:
+ *   the injection queue of `LockFreeTaskQueue` frees a node as soon as its
+ *   consumer takes it.
+ *
+ * @author dssregi
+ * @version 1.0
+ * @date 2025-11-14
+ */
+
+/**
+ * @brief Process-wide epoch-based memory reclamation domain.
+ *
+ * @thread_safety All methods are safe to call concurrently from any thread.
+ *                Each thread lazily claims a slot on first use and releases it
+ *                on thread exit.
+ */
+class EpochReclaimer {
+public:
+    /**
+     * @brief Number of slots per block; a further block is chained when all are claimed.
+     */
+    static constexpr int BLOCK_SLOTS = 64;
+
+    /**
+     * @brief Number of retirements after which a thread tries to advance the epoch.
+     */
+    static constexpr size_t BATCH = 64;
+
+private:
+    /**
+     * @brief Epoch value announced by threads outside any critical section.
+     */
+    static constexpr uint64_t QUIESCENT = std::numeric_limits<uint64_t>::max();
+
+    /**
+     * @brief Memory waiting for the epoch to advance.
+     */
+    struct Retired {
+        void* ptr;                  ///< Object to free.
+        void (*deleter)(void*);     ///< Type-erased deleter.
+        uint64_t epoch;             ///< Global epoch when the object was retired.
+    };
+
+    /**
+     * @brief Per-thread participant record, padded to its own cache line.
+     */
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{QUIESCENT}; ///< Announced epoch, or QUIESCENT.
+        std::atomic<bool> in_use{false};        ///< Claimed by a live thread.
+        int nesting = 0;                        ///< Pin depth (owner thread only).
+        std::vector<Retired> retired;           ///< Retire list (owner thread only).
+    };
+
+    /**
+     * @brief Group of participant slots; blocks are chained and never freed.
+     */
+    struct Block {
+        Slot slots[BLOCK_SLOTS];
+        std::atomic<Block*> next{nullptr};
+    };
+
+    /**
+     * @brief Global epoch counter.
+     */
+    alignas(64) std::atomic<uint64_t> global_epoch_{0};
+
+    /**
+     * @brief First block of participant slots, followed by any chained on demand.
+     */
+    Block first_;
+
+    /**
+     * @brief Retired objects left behind by exited threads.
+     */
+    std::vector<Retired> orphans_;
+
+    /**
+     * @brief Mutex protecting `orphans_`.
+     */
+    std::mutex orphans_mut_;
+
+    /**
+     * @brief Releases the calling thread's slot when the thread exits.
+     */
+    struct ThreadRecord {
+        Slot* slot = nullptr;
+        ~ThreadRecord() {
+            if (slot != nullptr) {
+                EpochReclaimer::instance().release(*slot);
+            }
+        }
+    };
+
+    EpochReclaimer() = default;
+
+    /**
+     * @brief Slot of the calling thread, claiming one on first use.
+     */
+    Slot& my_slot() {
+        static thread_local ThreadRecord record;
+        if (record.slot == nullptr) {
+            record.slot = &claim();
+        }
+        return *record.slot;
+    }
+
+    /**
+     * @brief Claim a free slot, chaining a new block if every slot is taken.
+     */
+    Slot& claim() {
+        for (Block* block = &first_; ; ) {
+            for (Slot& slot : block->slots) {
+                bool expected = false;
+                if (!slot.in_use.load(std::memory_order_relaxed) &&
+                    slot.in_use.compare_exchange_strong(expected, true)) {
+                    return slot;
+                }
+            }
+
+            Block* next = block->next.load(std::memory_order_acquire);
+            if (next == nullptr) {
+                // Whoever loses the race frees its block and moves on to the winner's
+                Block* fresh = new Block();
+                if (block->next.compare_exchange_strong(next, fresh)) {
+                    next = fresh;
+                } else {
+                    delete fresh;
+                }
+            }
+            block = next;
+        }
+    }
+
+    /**
+     * @brief Hand a departing thread's retire list to the orphan list and free its slot.
+     */
+    void release(Slot& slot) {
+        slot.epoch.store(QUIESCENT, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(orphans_mut_);
+            orphans_.insert(orphans_.end(), slot.retired.begin(), slot.retired.end());
+        }
+        slot.retired.clear();
+        slot.retired.shrink_to_fit();
+        slot.nesting = 0;
+        slot.in_use.store(false, std::memory_order_release);
+    }
+
+    /**
+     * @brief Advance the global epoch if every pinned thread has observed it.
+     *
+     * @return The (possibly new) global epoch.
+     */
+    uint64_t try_advance() {
+        uint64_t epoch = global_epoch_.load();
+        for (const Block* block = &first_; block != nullptr; block = block->next.load(std::memory_order_acquire)) {
+            for (const Slot& slot : block->slots) {
+                const uint64_t announced = slot.epoch.load(std::memory_order_acquire);
+                if (announced != QUIESCENT && announced != epoch) {
+                    return epoch;
+                }
+            }
+        }
+        global_epoch_.compare_exchange_strong(epoch, epoch + 1);
+        return global_epoch_.load();
+    }
+
+    /**
+     * @brief Free every entry of @p list retired at least two epochs before @p epoch.
+     */
+    static void free_expired(std::vector<Retired>& list, uint64_t epoch) {
+        size_t kept = 0;
+        for (size_t i = 0; i < list.size(); ++i) {
+            if (list[i].epoch + 2 <= epoch) {
+                list[i].deleter(list[i].ptr);
+            } else {
+                list[kept++] = list[i];
+            }
+        }
+        list.resize(kept);
+    }
+
+public:
+    /**
+     * @brief RAII critical section: while alive, memory retired by others stays valid.
+     */
+    class Guard {
+    private:
+        /**
+         * @brief Slot of the pinned thread.
+         */
+        Slot* slot_;
+
+    public:
+        explicit Guard(Slot* slot) : slot_(slot) {}
+
+        Guard(const Guard&) = delete;
+        Guard& operator =(const Guard&) = delete;
+
+        ~Guard() {
+            if (--slot_->nesting == 0) {
+                slot_->epoch.store(QUIESCENT, std::memory_order_release);
+            }
+        }
+    };
+
+    /**
+     * @brief Get the process-wide reclamation domain.
+     *
+     * Intentionally never destroyed, so threads exiting during static destruction
+     * can still release their slots.
+     */
+    static EpochReclaimer& instance() {
+        static EpochReclaimer* domain = new EpochReclaimer();
+        return *domain;
+    }
+
+    /**
+     * @brief Disable copy construction.
+     */
+    EpochReclaimer(const EpochReclaimer&) = delete;
+
+    /**
+     * @brief Disable copy assignment.
+     */
+    EpochReclaimer& operator =(const EpochReclaimer&) = delete;
+
+    /**
+     * @brief Enter a critical section (nestable).
+     *
+     * Costs one store plus a full fence on the outermost pin, which is why only
+     * non-owner paths should pin.
+     *
+     * @return Guard that leaves the critical section when destroyed.
+     */
+    Guard pin() {
+        Slot& slot = my_slot();
+        if (slot.nesting++ == 0) {
+            slot.epoch.store(global_epoch_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+        return Guard(&slot);
+    }
+
+    /**
+     * @brief Defer freeing memory until no pinned thread can reference it.
+     *
+     * The object must already be unreachable for threads that pin afterwards.
+     *
+     * @param ptr Object to free.
+     * @param deleter Function freeing @p ptr.
+     */
+    void retire(void* ptr, void (*deleter)(void*)) {
+        Slot& slot = my_slot();
+        slot.retired.push_back(Retired{ptr, deleter, global_epoch_.load()});
+        if (slot.retired.size() >= BATCH) {
+            collect();
+        }
+    }
+
+    /**
+     * @brief Defer `delete ptr` until no pinned thread can reference it.
+     */
+    template <class T>
+    void retire(T* ptr) {
+        retire(static_cast<void*>(ptr), [](void* p) { delete static_cast<T*>(p); });
+    }
+
+    /**
+     * @brief Try to advance the epoch and free the calling thread's expired retirements.
+     */
+    void collect() {
+        Slot& slot = my_slot();
+        const uint64_t epoch = try_advance();
+        free_expired(slot.retired, epoch);
+
+        std::unique_lock<std::mutex> lock(orphans_mut_, std::try_to_lock);
+        if (lock.owns_lock() && !orphans_.empty()) {
+            free_expired(orphans_, epoch);
+        }
+    }
+
+    /**
+     * @brief Number of objects the calling thread has retired but not yet freed.
+     */
+    size_t pending() {
+        return my_slot().retired.size();
+    }
+};
+
+#endif // __EPOCH_RECLAIMER_HPP__
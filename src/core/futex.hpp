@@ -0,0 +1,88 @@
+#ifndef __FUTEX_HPP__
+#define __FUTEX_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <cerrno>
+#include <type_traits>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/**
+ * @file futex.hpp
+ * @brief Thin wrappers around the Linux futex system call.
+ *
+ * `std::atomic<T>::wait` has no timed variant, and the pool's blocking queues
+ * need one to bound a worker's park by the next timer expiry. These helpers
+ * wait on a 32-bit atomic word directly, with an optional absolute deadline.
+ *
+ * @details
+ * - Waits use `FUTEX_WAIT_BITSET`, whose timeout is an absolute
+ *   `CLOCK_MONOTONIC` time (`std::chrono::steady_clock` on Linux), so a
+ *   deadline does not drift when the wait is interrupted and retried.
+ * - Futexes are process-private; the words must not live in shared memory
+ *   mapped by several processes.
+ *
+ * @author dssregi
+ * @version 1.0
+ * @date 2025-11-14
+ */
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && std::atomic<uint32_t>::is_always_lock_free,
+              "futex words must be plain 32-bit atomics");
+
+/**
+ * @brief Block while @p word holds @p expected, until woken or @p deadline passes.
+ *
+ * May return spuriously; callers re-check their condition in a loop.
+ *
+ * @param word Futex word.
+ * @param expected Value observed by the caller before deciding to wait.
+ * @param deadline Absolute `CLOCK_MONOTONIC` time, or nullptr to wait without timeout.
+ * @return false if the deadline passed, true otherwise (woken, value changed or interrupted).
+ */
+inline bool futex_wait(std::atomic<uint32_t>& word, uint32_t expected, const timespec* deadline = nullptr) {
+    long rc = ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_BITSET | FUTEX_PRIVATE_FLAG,
+                        expected, deadline, nullptr, FUTEX_BITSET_MATCH_ANY);
+    return rc == 0 || errno != ETIMEDOUT;
+}
+
+/**
+ * @brief Wake up to @p count threads blocked on @p word.
+ *
+ * @return Number of threads woken.
+ */
+inline int futex_wake(std::atomic<uint32_t>& word, int count = 1) {
+    return static_cast<int>(::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word),
+                                      FUTEX_WAKE | FUTEX_PRIVATE_FLAG, count, nullptr, nullptr, 0));
+}
+
+/**
+ * @brief Convert a time point of any clock to an absolute `CLOCK_MONOTONIC` timespec.
+ *
+ * Time points of other clocks are translated through the current offset between
+ * the two clocks.
+ */
+template <class Clock, class Duration>
+inline timespec to_monotonic_timespec(const std::chrono::time_point<Clock, Duration>& deadline) {
+    using namespace std::chrono;
+    steady_clock::time_point steady;
+    if constexpr (std::is_same_v<Clock, steady_clock>) {
+        steady = time_point_cast<steady_clock::duration>(deadline);
+    } else {
+        steady = steady_clock::now() + duration_cast<steady_clock::duration>(deadline - Clock::now());
+    }
+
+    const auto since_epoch = duration_cast<nanoseconds>(steady.time_since_epoch());
+    if (since_epoch.count() <= 0) {
+        return timespec{0, 0};
+    }
+    return timespec{static_cast<time_t>(since_epoch.count() / 1000000000),
+                    static_cast<long>(since_epoch.count() % 1000000000)};
+}
+
+#endif // __FUTEX_HPP__
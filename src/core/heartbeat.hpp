@@ -0,0 +1,296 @@
+#ifndef __HEARTBEAT_HPP__
+#define __HEARTBEAT_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <type_traits>
+
+#include "thread_pool.hpp"
+
+/**
+ * @file heartbeat.hpp
+ * @brief Heartbeat-scheduled parallel loops (lazy binary splitting).
+ *
+ * Choosing a task granularity by hand is fragile: one task per iteration drowns
+ * small inputs in scheduling overhead, a fixed chunk size under-decomposes large
+ * ones. `heartbeat_for` runs a loop serially by default and only *promotes*
+ * parallelism when it is cheap relative to the work already done: once per
+ * heartbeat interval, or immediately when an idle worker is observed.
+ *
+ * @details
+ * - A promotion splits the iterations still left in the current range in half
+ *   and publishes the upper half; the running thread continues with the lower
+ *   half. Every promoted range is itself run under the same heartbeat rule.
+ * - Because at most one promotion happens per heartbeat per running range, the
+ *   task-creation overhead is bounded by (promotion cost / interval), whatever
+ *   the trip count or per-iteration cost.
+ * - Promoted ranges sit in a per-loop deque; the pool receives lightweight
+ *   "pull" tasks that take a range from it. The calling thread drains the same
+ *   deque once its own range is done, so the loop makes progress even when every
+ *   worker is busy (or the caller is itself a worker).
+ *
+ * @author dssregi
+ * @version 1.0
+ * @date 2025-11-14
+ */
+
+/**
+ * @brief Tuning knobs for `heartbeat_for`.
+ */
+struct HeartbeatOptions {
+    /**
+     * @brief Minimum serial running time between two promotions of the same range.
+     */
+    std::chrono::microseconds interval{100};
+
+    /**
+     * @brief Number of iterations between two heartbeat checks.
+     *
+     * Checking reads the clock; raise this for loops whose iterations take only
+     * a few nanoseconds.
+     */
+    int poll_stride = 1;
+
+    /**
+     * @brief Smallest range (in iterations) worth splitting.
+     */
+    long min_split = 2;
+
+    /**
+     * @brief Tag attributed to promoted-range tasks for profiling, or nullptr.
+     */
+    const TaskTag* tag = nullptr;
+};
+
+/**
+ * @brief Shared state of one `heartbeat_for` invocation.
+ *
+ * @tparam Body Loop body type, invoked as `body(i)`.
+ *
+ * @details
+ * Owned through `std::shared_ptr` so late pull tasks, which may run after the
+ * loop has returned, find an empty range deque instead of a dangling object.
+ * `body_` is only dereferenced while iterations remain, i.e. while the calling
+ * thread is still inside `heartbeat_for`.
+ */
+template <class Body>
+class HeartbeatLoop {
+private:
+    /**
+     * @brief Half-open iteration range [begin, end).
+     */
+    struct Range {
+        long begin = 0;
+        long end = 0;
+    };
+
+    /**
+     * @brief Pool receiving pull tasks for promoted ranges.
+     */
+    ThreadPool& pool_;
+
+    /**
+     * @brief Loop body, owned by the caller of `heartbeat_for`.
+     */
+    Body* body_;
+
+    /**
+     * @brief Heartbeat configuration.
+     */
+    const HeartbeatOptions options_;
+
+    /**
+     * @brief Promoted ranges not yet taken by a pull task or the caller.
+     */
+    ThreadSafeDeque<Range> ranges_{std::numeric_limits<size_t>::max()};
+
+    /**
+     * @brief Number of entries in `ranges_`; promotion is throttled while
+     *        previously promoted ranges are still waiting for a thief.
+     */
+    std::atomic<long> pending_{0};
+
+    /**
+     * @brief Iterations not yet executed; the loop is complete when it reaches zero.
+     */
+    std::atomic<long> remaining_;
+
+    /**
+     * @brief Number of ranges promoted so far.
+     */
+    std::atomic<long> promoted_{0};
+
+public:
+    /**
+     * @brief Create the state for a loop of @p count iterations.
+     */
+    HeartbeatLoop(ThreadPool& pool, Body* body, HeartbeatOptions options, long count)
+        : pool_(pool), body_(body), options_(options), remaining_(count) {}
+
+    /**
+     * @brief Run [begin, end) serially, promoting the upper half of what is left on
+     *        every heartbeat or when a worker is idle.
+     *
+     * @param self Owning pointer to this loop, captured by the pull tasks.
+     */
+    void run(const std::shared_ptr<HeartbeatLoop>& self, long begin, long end) {
+        using Clock = std::chrono::steady_clock;
+
+        Clock::time_point last_beat = Clock::now();
+        long executed = 0;
+        int since_poll = 0;
+
+        for (long i = begin; i < end; ++i) {
+            (*body_)(i);
+            ++executed;
+
+            if (++since_poll < options_.poll_stride || end - (i + 1) < options_.min_split) {
+                continue;
+            }
+            since_poll = 0;
+
+            // Ranges nobody has picked up yet mean the pool is saturated: promoting
+            // more would only queue tasks (and could fill the bounded work queues).
+            long pending = pending_.load(std::memory_order_relaxed);
+            if (pending >= pool_.size()) {
+                continue;
+            }
+
+            bool thief_waiting = pending == 0 && pool_.idle_workers() > 0;
+            Clock::time_point now = Clock::now();
+            if (!thief_waiting && now - last_beat < options_.interval) {
+                continue;
+            }
+            last_beat = now;
+
+            // Promote the upper half of the iterations left in this range.
+            long mid = (i + 1) + (end - (i + 1)) / 2;
+            promote(self, mid, end);
+            end = mid;
+        }
+
+        finish(executed);
+    }
+
+    /**
+     * @brief Take one promoted range, if any, and run it.
+     *
+     * @return true if a range was run.
+     */
+    bool run_pending(const std::shared_ptr<HeartbeatLoop>& self) {
+        Range range;
+        if (!ranges_.try_steal(range)) {
+            return false;
+        }
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+        run(self, range.begin, range.end);
+        return true;
+    }
+
+    /**
+     * @brief Block until every iteration has executed.
+     */
+    void wait() {
+        long left = remaining_.load();
+        while (left != 0) {
+            remaining_.wait(left);
+            left = remaining_.load();
+        }
+    }
+
+    /**
+     * @brief Number of ranges promoted to parallel tasks.
+     */
+    long promoted() const {
+        return promoted_.load();
+    }
+
+private:
+    /**
+     * @brief Publish [begin, end) and hand the pool a task that pulls it.
+     */
+    void promote(const std::shared_ptr<HeartbeatLoop>& self, long begin, long end) {
+        promoted_.fetch_add(1, std::memory_order_relaxed);
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        ranges_.push(Range{begin, end});
+        if (options_.tag != nullptr) {
+            pool_.submit([self] { self->run_pending(self); }, *options_.tag);
+        } else {
+            pool_.submit([self] { self->run_pending(self); });
+        }
+    }
+
+    /**
+     * @brief Retire @p executed iterations, waking the caller when the loop is done.
+     */
+    void finish(long executed) {
+        if (remaining_.fetch_sub(executed) == executed) {
+            remaining_.notify_all();
+        }
+    }
+};
+
+/**
+ * @brief Execute `body(i)` for every i in [begin, end) with heartbeat-driven splitting.
+ *
+ * The calling thread starts running the whole range serially; parallel tasks are
+ * created only on heartbeats or when a worker is idle (see file documentation).
+ * Returns once every iteration has completed.
+ *
+ * @param pool Pool that executes promoted ranges.
+ * @param begin First iteration (inclusive).
+ * @param end Last iteration (exclusive).
+ * @param body Callable invoked as `body(i)`; may run concurrently for different i.
+ * @param options Heartbeat interval and polling configuration.
+ * @return Number of ranges that were promoted to parallel tasks.
+ */
+template <class Body>
+long heartbeat_for(ThreadPool& pool, long begin, long end, Body&& body, HeartbeatOptions options = {}) {
+    if (end <= begin) {
+        return 0;
+    }
+
+    using Loop = HeartbeatLoop<std::remove_reference_t<Body>>;
+    auto loop = std::make_shared<Loop>(pool, &body, options, end - begin);
+
+    loop->run(loop, begin, end);
+    while (loop->run_pending(loop)) {
+    }
+    loop->wait();
+    return loop->promoted();
+}
+
+/**
+ * @brief Execute `body(lo, hi)` over [begin, end) in chunks of @p grain iterations,
+ *        with heartbeat-driven splitting.
+ *
+ * Promotions split between chunks, so every call covers a whole chunk that
+ * starts at `begin + k * grain` (only the last may be shorter). Use it when the
+ * body works better on contiguous runs than on single iterations.
+ *
+ * @param pool Pool that executes promoted ranges.
+ * @param begin First iteration (inclusive).
+ * @param end Last iteration (exclusive).
+ * @param grain Iterations per call; at least 1.
+ * @param body Callable invoked as `body(lo, hi)`; may run concurrently for disjoint chunks.
+ * @param options Heartbeat interval and polling configuration.
+ * @return Number of ranges that were promoted to parallel tasks.
+ */
+template <class Body>
+long heartbeat_for_chunks(ThreadPool& pool, long begin, long end, long grain, Body&& body, HeartbeatOptions options = {}) {
+    if (end <= begin) {
+        return 0;
+    }
+    grain = std::max(grain, 1L);
+    const long chunks = (end - begin + grain - 1) / grain;
+    return heartbeat_for(pool, 0, chunks, [&](long k) {
+        const long lo = begin + k * grain;
+        body(lo, std::min(lo + grain, end));
+    }, options);
+}
+
+#endif // __HEARTBEAT_HPP__
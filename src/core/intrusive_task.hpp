@@ -0,0 +1,202 @@
+#ifndef __INTRUSIVE_TASK_HPP__
+#define __INTRUSIVE_TASK_HPP__
+
+#include <mutex>
+#include <atomic>
+
+#include "task_profiler.hpp"
+
+/**
+ * @file intrusive_task.hpp
+ * @brief Intrusive task nodes and the per-worker deque that links them.
+ *
+ * Submitting a callable through `std::function` copies it (allocating when the
+ * capture is large) and `ThreadSafeDeque` allocates a `unique_ptr` per entry.
+ * For long-lived work items this is pure overhead. An `IntrusiveTask` instead
+ * carries the scheduler's link fields itself: it is submitted by pointer, queued
+ * without copies or allocations, and the pool never owns its storage (the model
+ * of TBB's `task` or Linux's `work_struct`).
+ *
+ * @author dssregi
+ * @version 1.0
+ * @date 2025-11-14
+ */
+
+/**
+ * @brief Base class for work items linked directly into the pool's queues.
+ *
+ * @details
+ * - Derive, override `execute()`, and submit with `ThreadPool::submit(IntrusiveTask&)`.
+ * - The object must stay alive until `execute()` has been entered. The task is
+ *   unlinked before `execute()` runs, so `execute()` may resubmit or destroy it.
+ * - A task may be queued at most once at a time.
+ *
+ * @thread_safety The link fields are only touched under the lock of the deque
+ *                the task is queued in.
+ */
+class IntrusiveTask {
+private:
+    /**
+     * @brief Older neighbour in the queue.
+     */
+    IntrusiveTask* prev_ = nullptr;
+
+    /**
+     * @brief Newer neighbour in the queue.
+     */
+    IntrusiveTask* next_ = nullptr;
+
+    /**
+     * @brief Tag the task was last submitted with, or nullptr.
+     */
+    const TaskTag* tag_ = nullptr;
+
+    friend class IntrusiveTaskDeque;
+    template <class, class, class> friend class BasicThreadPool;
+
+public:
+    IntrusiveTask() = default;
+
+    /**
+     * @brief Copying a task copies its payload, never its queue links.
+     */
+    IntrusiveTask(const IntrusiveTask&) {}
+
+    /**
+     * @brief Assigning a task leaves the target's queue links untouched.
+     */
+    IntrusiveTask& operator =(const IntrusiveTask&) { return *this; }
+
+    /**
+     * @brief Run the work item. Called once per submission by a pool worker.
+     */
+    virtual void execute() = 0;
+
+protected:
+    /**
+     * @brief Tasks are owned by their submitter, never deleted through this base.
+     */
+    ~IntrusiveTask() = default;
+};
+
+/**
+ * @brief Doubly-linked deque of intrusive tasks (owner LIFO, thieves FIFO).
+ *
+ * @details
+ * Mirrors the owner/thief interface of `ThreadSafeDeque` but never allocates:
+ * push and pop only rewrite the embedded links. It is unbounded and never
+ * blocks; the pool wakes parked workers itself.
+ *
+ * @thread_safety All operations are safe for concurrent use and serialized by
+ *                an internal mutex.
+ */
+class IntrusiveTaskDeque {
+private:
+    /**
+     * @brief Mutex protecting the list.
+     */
+    std::mutex mut_;
+
+    /**
+     * @brief Oldest task (stolen first).
+     */
+    IntrusiveTask* head_ = nullptr;
+
+    /**
+     * @brief Newest task (popped first by the owner).
+     */
+    IntrusiveTask* tail_ = nullptr;
+
+    /**
+     * @brief Number of queued tasks, readable without the lock.
+     *
+     * Updated with sequentially consistent operations so a submitter and a
+     * parking worker cannot both miss each other (see `ThreadPool::park`).
+     */
+    std::atomic<long> size_{0};
+
+    /**
+     * @brief Unlink @p task (lock held).
+     */
+    void unlink(IntrusiveTask* task) {
+        (task->prev_ ? task->prev_->next_ : head_) = task->next_;
+        (task->next_ ? task->next_->prev_ : tail_) = task->prev_;
+        task->prev_ = task->next_ = nullptr;
+        size_.fetch_sub(1);
+    }
+
+public:
+    IntrusiveTaskDeque() = default;
+
+    /**
+     * @brief Disable copy construction.
+     */
+    IntrusiveTaskDeque(const IntrusiveTaskDeque&) = delete;
+
+    /**
+     * @brief Disable copy assignment.
+     */
+    IntrusiveTaskDeque& operator =(const IntrusiveTaskDeque&) = delete;
+
+    /**
+     * @brief Link @p task at the back (newest end).
+     */
+    void push(IntrusiveTask* task) {
+        std::lock_guard<std::mutex> lock(mut_);
+        task->prev_ = tail_;
+        task->next_ = nullptr;
+        (tail_ ? tail_->next_ : head_) = task;
+        tail_ = task;
+        size_.fetch_add(1);
+    }
+
+    /**
+     * @brief Unlink and return the newest task (owner LIFO pop).
+     *
+     * @return The task, or nullptr if the deque was empty.
+     */
+    IntrusiveTask* try_pop() {
+        if (empty()) {
+            return nullptr;
+        }
+        std::lock_guard<std::mutex> lock(mut_);
+        IntrusiveTask* task = tail_;
+        if (task) {
+            unlink(task);
+        }
+        return task;
+    }
+
+    /**
+     * @brief Unlink and return the oldest task (thief FIFO pop).
+     *
+     * @return The task, or nullptr if the deque was empty.
+     */
+    IntrusiveTask* try_steal() {
+        if (empty()) {
+            return nullptr;
+        }
+        std::lock_guard<std::mutex> lock(mut_);
+        IntrusiveTask* task = head_;
+        if (task) {
+            unlink(task);
+        }
+        return task;
+    }
+
+    /**
+     * @brief Lock-free emptiness check (sequentially consistent).
+     */
+    bool empty() const {
+        return size_.load() == 0;
+    }
+
+    /**
+     * @brief Number of queued tasks (racy snapshot, for monitoring).
+     */
+    long size() const {
+        return size_.load(std::memory_order_relaxed);
+    }
+};
+
+#endif // __INTRUSIVE_TASK_HPP__
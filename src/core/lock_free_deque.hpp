@@ -0,0 +1,233 @@
+#ifndef __LOCK_FREE_DEQUE_HPP__
+#define __LOCK_FREE_DEQUE_HPP__
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+#include "epoch_reclaimer.hpp"
+#include "huge_page_allocator.hpp"
+
+/**
+ * @file lock_free_deque.hpp
+ * @brief Growable lock-free work-stealing deque (Chase-Lev).
+ *
+ * The owner pushes and pops at the bottom without locks; thieves take from the
+ * top with a single CAS. When the circular buffer is full the owner copies it
+ * into one twice as large. The old buffer cannot be freed immediately because a
+ * thief that loaded the buffer pointer just before the swap may still read from
+ * it, so it is retired through the process-wide `EpochReclaimer`.
+ *
+ * @details
+ * - Memory orderings follow Lê, Pop, Cohen and Zappa Nardelli, "Correct and
+ *   Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013).
+ * - Only `steal` pins an epoch. The owner never reads a buffer it has replaced,
+ *   so `push` and `pop` carry no reclamation cost; `grow` only appends to the
+ *   owner's private retire list.
+ * - `LockFreeTaskQueue` keeps its owner's tasks here (as node pointers), so the
+ *   `ThroughputThreadPool`, `LowLatencyThreadPool` and `PollingThreadPool`
+ *   workers push, pop and steal through it.
+ *
+ * @author dssregi
+ * @version 1.0
+ * @date 2025-11-14
+ */
+
+/**
+ * @brief Growable single-owner, multi-thief lock-free deque.
+ *
+ * @tparam T Element type. Must be trivially copyable because elements live in
+ *           `std::atomic<T>` slots; store pointers or handles for larger objects.
+ *
+ * @thread_safety `push` and `pop` may only be called by the owning thread;
+ *                `steal`, `empty` and `size` may be called from any thread.
+ */
+template <class T>
+class LockFreeDeque {
+    static_assert(std::is_trivially_copyable_v<T>, "LockFreeDeque stores elements in std::atomic<T>");
+
+private:
+    /**
+     * @brief Circular buffer whose capacity is a power of two.
+     */
+    struct Buffer {
+        const int64_t capacity;
+        std::atomic<T>* const slots;
+
+        // Deep deques (millions of entries) land on huge pages like other large buffers
+        explicit Buffer(int64_t cap)
+            : capacity(cap), slots(HugePageAllocator<std::atomic<T>>().allocate(static_cast<size_t>(cap))) {
+            for (int64_t i = 0; i < cap; ++i) {
+                new (&slots[i]) std::atomic<T>();
+            }
+        }
+
+        ~Buffer() {
+            HugePageAllocator<std::atomic<T>>().deallocate(slots, static_cast<size_t>(capacity));
+        }
+
+        T get(int64_t index) const {
+            return slots[index & (capacity - 1)].load(std::memory_order_relaxed);
+        }
+
+        void put(int64_t index, T value) {
+            slots[index & (capacity - 1)].store(value, std::memory_order_relaxed);
+        }
+    };
+
+    /**
+     * @brief Index of the oldest element (advanced by thieves and the last-element pop).
+     */
+    alignas(64) std::atomic<int64_t> top_{0};
+
+    /**
+     * @brief Index one past the newest element (written by the owner only).
+     */
+    alignas(64) std::atomic<int64_t> bottom_{0};
+
+    /**
+     * @brief Current buffer; replaced by the owner in `grow`.
+     */
+    alignas(64) std::atomic<Buffer*> buffer_;
+
+    /**
+     * @brief Copy the live range [top, bottom) into a buffer twice as large.
+     *
+     * @return The new buffer.
+     */
+    Buffer* grow(Buffer* old, int64_t top, int64_t bottom) {
+        Buffer* bigger = new Buffer(old->capacity * 2);
+        for (int64_t i = top; i < bottom; ++i) {
+            bigger->put(i, old->get(i));
+        }
+        buffer_.store(bigger, std::memory_order_release);
+        EpochReclaimer::instance().retire(old);
+        return bigger;
+    }
+
+public:
+    /**
+     * @brief Construct an empty deque.
+     *
+     * @param capacity Initial capacity, rounded up to a power of two.
+     */
+    explicit LockFreeDeque(int64_t capacity = 64) {
+        int64_t cap = 1;
+        while (cap < capacity) {
+            cap <<= 1;
+        }
+        buffer_.store(new Buffer(cap), std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Free the current buffer; retired buffers are freed by the reclaimer.
+     *
+     * No thread may access the deque concurrently with destruction.
+     */
+    ~LockFreeDeque() {
+        delete buffer_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Disable copy construction.
+     */
+    LockFreeDeque(const LockFreeDeque&) = delete;
+
+    /**
+     * @brief Disable copy assignment.
+     */
+    LockFreeDeque& operator =(const LockFreeDeque&) = delete;
+
+    /**
+     * @brief Push a value onto the bottom (owner operation). Never blocks; grows when full.
+     */
+    void push(T value) {
+        const int64_t b = bottom_.load(std::memory_order_relaxed);
+        const int64_t t = top_.load(std::memory_order_acquire);
+        Buffer* buf = buffer_.load(std::memory_order_relaxed);
+
+        if (b - t > buf->capacity - 1) {
+            buf = grow(buf, t, b);
+        }
+
+        buf->put(b, value);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Pop the newest value from the bottom (owner LIFO pop).
+     *
+     * @param[out] value Where the popped value is placed if pop succeeds.
+     * @return true if a value was popped, false if the deque was empty or the
+     *         last element was lost to a thief.
+     */
+    bool pop(T& value) {
+        const int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        Buffer* buf = buffer_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        value = buf->get(b);
+        if (t == b) {
+            // Last element: race the thieves for it.
+            const bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                          std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Steal the oldest value from the top (non-owner FIFO pop).
+     *
+     * @param[out] value Where the stolen value is placed if steal succeeds.
+     * @return true if a value was stolen, false if the deque was empty or
+     *         another thread won the race for the top element.
+     */
+    bool steal(T& value) {
+        auto guard = EpochReclaimer::instance().pin();
+
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = bottom_.load(std::memory_order_acquire);
+
+        if (t >= b) {
+            return false;
+        }
+
+        Buffer* buf = buffer_.load(std::memory_order_acquire);
+        T stolen = buf->get(t);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            return false;
+        }
+        value = stolen;
+        return true;
+    }
+
+    /**
+     * @brief Approximate number of elements (exact when called by a quiescent owner).
+     */
+    int64_t size() const {
+        const int64_t b = bottom_.load(std::memory_order_relaxed);
+        const int64_t t = top_.load(std::memory_order_relaxed);
+        return b > t ? b - t : 0;
+    }
+
+    /**
+     * @brief Approximate emptiness check.
+     */
+    bool empty() const {
+        return size() == 0;
+    }
+};
+
+#endif // __LOCK_FREE_DEQUE_HPP__
@@ -0,0 +1,409 @@
+#ifndef __LOCK_FREE_TASK_QUEUE_HPP__
+#define __LOCK_FREE_TASK_QUEUE_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <utility>
+
+#include "lock_free_deque.hpp"
+#include "futex.hpp"
+#include "node_arena.hpp"
+
+/**
+ * @file lock_free_task_queue.hpp
+ * @brief Unbounded lock-free work-stealing task queue with futex-based blocking pops.
+ *
+ * A drop-in alternative to `ThreadSafeDeque` for the pool's per-worker task
+ * queues (`LockFreeQueue` policy): the same owner/thief operations, but no
+ * operation takes a lock, and an idle owner parks on a futex rather than a
+ * condition variable.
+ *
+ * @details
+ * - Tasks the owner pushes go to a Chase-Lev `LockFreeDeque`: the owner pops
+ *   the newest (LIFO, cache-warm), thieves steal the oldest (FIFO, typically
+ *   the largest piece of a divide-and-conquer split). Owner push and pop touch
+ *   only the bottom index and pin no epoch; only thieves do.
+ * - Tasks pushed by any other thread (outside submissions, peers' submissions,
+ *   wake-up nudges) go to a separate multi-producer injection queue (Vyukov's
+ *   intrusive MPSC queue), so producers never write the owner's bottom index.
+ *   Its single consumer role is taken with a try-lock, by the owner or by a
+ *   thief, and the owner drains it FIFO once its deque is empty.
+ * - The owner is the thread that first calls `try_pop` or a blocking pop.
+ *   Until then every push is injected, which is correct, only less local.
+ * - Every element is a node from the pooled, huge-page backed `NodeArena`, so
+ *   elements of any MoveConstructible type fit in the deque's trivially copyable
+ *   slots; a node belongs to whoever won it.
+ * - Wake-ups cost a futex call only when the owner is actually waiting.
+ *
+ * @author dssregi
+ * @version 1.0
+ * @date 2025-11-14
+ */
+
+/**
+ * @brief Unbounded lock-free single-owner, multi-thief, multi-producer task queue.
+ *
+ * @tparam T Element type (MoveConstructible).
+ *
+ * @thread_safety `push`, `try_steal`, `try_steal_if`, `close`, `empty` and
+ *                `size` may be called from any thread; `try_pop`, `try_pop_if`
+ *                and the blocking pops only by the owning thread.
+ */
+template <class T>
+class LockFreeTaskQueue {
+private:
+    /**
+     * @brief Link of the injection queue.
+     */
+    struct Link {
+        std::atomic<Link*> next{nullptr};
+    };
+
+    /**
+     * @brief Arena node holding one element, in the deque or the injection queue.
+     */
+    struct Node : Link {
+        T value;
+        explicit Node(T v) : value(std::move(v)) {}
+    };
+
+    /**
+     * @brief Elements pushed by the owner.
+     */
+    LockFreeDeque<Node*> local_;
+
+    /**
+     * @brief Newest injected link; producers swap themselves in here.
+     */
+    alignas(64) std::atomic<Link*> tail_;
+
+    /**
+     * @brief Oldest injected link (or the stub); owned by the consumer-role holder.
+     */
+    alignas(64) Link* head_;
+
+    /**
+     * @brief Placeholder re-linked whenever the injection queue would otherwise run empty.
+     */
+    Link stub_;
+
+    /**
+     * @brief Consumer role of the injection queue, held by the owner or one thief.
+     */
+    std::atomic<bool> consuming_{false};
+
+    /**
+     * @brief Injected elements not yet consumed; counted before they are linked.
+     */
+    std::atomic<int64_t> injected_{0};
+
+    /**
+     * @brief Token of the owning thread, or nullptr until its first pop.
+     */
+    std::atomic<const void*> owner_{nullptr};
+
+    /**
+     * @brief Futex word, bumped whenever a waiter must re-check the queue.
+     */
+    std::atomic<uint32_t> seq_{0};
+
+    /**
+     * @brief Threads inside a blocking pop; pushes skip the wake-up while zero.
+     */
+    std::atomic<int> waiters_{0};
+
+    /**
+     * @brief Set by `close`; blocking pops return once the queue is empty.
+     */
+    std::atomic<bool> done_{false};
+
+    /**
+     * @brief Address unique to the calling thread.
+     */
+    static const void* self_token() {
+        static thread_local char token;
+        return &token;
+    }
+
+    /**
+     * @brief Append @p link to the injection queue (no counting, no wake-up).
+     */
+    void link(Link* link) {
+        link->next.store(nullptr, std::memory_order_relaxed);
+        Link* prev = tail_.exchange(link, std::memory_order_acq_rel);
+        prev->next.store(link, std::memory_order_release);
+    }
+
+    /**
+     * @brief Count, append and announce an element pushed by a non-owner.
+     */
+    void inject(Node* node) {
+        // Counted first: a waiter that reads zero has really nothing to pop
+        injected_.fetch_add(1);
+        link(node);
+        if (waiters_.load() > 0) {
+            seq_.fetch_add(1);
+            futex_wake(seq_, 1);
+        }
+    }
+
+    /**
+     * @brief Unlink the oldest injected node (consumer role held).
+     *
+     * @return The node, or nullptr if the queue is empty or a producer has
+     *         swapped in the tail but not linked it yet.
+     */
+    Node* dequeue_locked() {
+        Link* head = head_;
+        Link* next = head->next.load(std::memory_order_acquire);
+        if (head == &stub_) {
+            if (next == nullptr) {
+                return nullptr;
+            }
+            head_ = next;
+            head = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next != nullptr) {
+            head_ = next;
+            return static_cast<Node*>(head);
+        }
+        if (tail_.load(std::memory_order_acquire) != head) {
+            return nullptr;
+        }
+
+        // head is the only node: put the stub behind it so it can be unlinked
+        link(&stub_);
+        next = head->next.load(std::memory_order_acquire);
+        if (next != nullptr) {
+            head_ = next;
+            return static_cast<Node*>(head);
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Take the oldest injected element if @p pred accepts it.
+     *
+     * A rejected element is linked back at the tail, so an owner-only entry at
+     * the head does not hide the entries behind it from thieves for long.
+     */
+    template <class Pred>
+    bool take_injected(T& value, Pred pred) {
+        bool expected = false;
+        if (injected_.load(std::memory_order_relaxed) == 0 || consuming_.load(std::memory_order_relaxed) ||
+            !consuming_.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return false;
+        }
+
+        bool taken = false;
+        if (Node* node = dequeue_locked()) {
+            if (pred(std::as_const(node->value))) {
+                value = std::move(node->value);
+                arena_delete(node);
+                injected_.fetch_sub(1);
+                taken = true;
+            } else {
+                link(node);
+            }
+        }
+        consuming_.store(false, std::memory_order_release);
+        return taken;
+    }
+
+    /**
+     * @brief Record the calling thread as the owner if nobody popped yet.
+     */
+    void bind_owner() {
+        if (owner_.load(std::memory_order_relaxed) == nullptr) {
+            owner_.store(self_token(), std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Pop, parking on the futex until an element arrives, the queue is
+     *        closed, or @p deadline passes.
+     */
+    bool wait_and_take(T& value, const timespec* deadline) {
+        while (true) {
+            if (try_pop(value)) {
+                return true;
+            }
+            if (done_.load()) {
+                return try_pop(value);
+            }
+
+            // Announce before sampling the word: an injection either sees the
+            // waiter and bumps the word, or is counted before the check below.
+            waiters_.fetch_add(1);
+            const uint32_t seq = seq_.load();
+            bool in_time = true;
+            if (injected_.load() == 0 && local_.empty() && !done_.load()) {
+                in_time = futex_wait(seq_, seq, deadline);
+            }
+            waiters_.fetch_sub(1);
+
+            if (!in_time) {
+                return try_pop(value);
+            }
+        }
+    }
+
+public:
+    LockFreeTaskQueue() : tail_(&stub_), head_(&stub_) {}
+
+    /**
+     * @brief Destroy the elements still queued.
+     *
+     * No thread may access the queue concurrently with destruction.
+     */
+    ~LockFreeTaskQueue() {
+        Node* node = nullptr;
+        while (local_.pop(node)) {
+            arena_delete(node);
+        }
+        while ((node = dequeue_locked()) != nullptr) {
+            arena_delete(node);
+        }
+    }
+
+    /**
+     * @brief Disable copy construction.
+     */
+    LockFreeTaskQueue(const LockFreeTaskQueue&) = delete;
+
+    /**
+     * @brief Disable copy assignment.
+     */
+    LockFreeTaskQueue& operator =(const LockFreeTaskQueue&) = delete;
+
+    /**
+     * @brief Push a value; never blocks.
+     *
+     * The owner pushes onto its deque, every other thread into the injection queue.
+     */
+    void push(T value) {
+        Node* node = arena_new<Node>(std::move(value));
+        if (owner_.load(std::memory_order_relaxed) == self_token()) {
+            local_.push(node);
+            return;
+        }
+        inject(node);
+    }
+
+    /**
+     * @brief Pop the newest owner-pushed value, else the oldest injected one
+     *        (owner operation). Non-blocking.
+     *
+     * @return true if a value was popped.
+     */
+    bool try_pop(T& value) {
+        return try_pop_if(value, [](const T&) { return true; });
+    }
+
+    /**
+     * @brief Pop as `try_pop` does, if @p pred accepts the value (owner operation).
+     *
+     * @param pred Called as `pred(const T&)`; a rejected value stays queued.
+     * @return true if a value was popped.
+     */
+    template <class Pred>
+    bool try_pop_if(T& value, Pred pred) {
+        bind_owner();
+        Node* node = nullptr;
+        if (local_.pop(node)) {
+            if (!pred(std::as_const(node->value))) {
+                local_.push(node);
+                return false;
+            }
+            value = std::move(node->value);
+            arena_delete(node);
+            return true;
+        }
+        return take_injected(value, pred);
+    }
+
+    /**
+     * @brief Steal a value (thief operation). Non-blocking.
+     *
+     * @return true if a value was stolen.
+     */
+    bool try_steal(T& value) {
+        return try_steal_if(value, [](const T&) { return true; });
+    }
+
+    /**
+     * @brief Steal the oldest owner-pushed value, else the oldest injected one,
+     *        if @p pred accepts it (thief operation). Non-blocking.
+     *
+     * A value is only inspected once the thief owns it; one taken from the
+     * deque and rejected is handed back through the injection queue.
+     *
+     * @param pred Called as `pred(const T&)`.
+     * @return true if a value was stolen.
+     */
+    template <class Pred>
+    bool try_steal_if(T& value, Pred pred) {
+        Node* node = nullptr;
+        if (local_.steal(node)) {
+            if (!pred(std::as_const(node->value))) {
+                inject(node);
+                return false;
+            }
+            value = std::move(node->value);
+            arena_delete(node);
+            return true;
+        }
+        return take_injected(value, pred);
+    }
+
+    /**
+     * @brief Block until a value can be popped or the queue is closed and empty.
+     *
+     * @return true if a value was popped, false if the queue was closed.
+     */
+    bool wait_and_pop(T& value) {
+        return wait_and_take(value, nullptr);
+    }
+
+    /**
+     * @brief Block until a value can be popped, the queue is closed and empty,
+     *        or @p deadline passes.
+     *
+     * @return true if a value was popped, false on timeout or if the queue was closed.
+     */
+    template <class Clock, class Duration>
+    bool wait_and_pop_until(T& value, const std::chrono::time_point<Clock, Duration>& deadline) {
+        const timespec abs = to_monotonic_timespec(deadline);
+        return wait_and_take(value, &abs);
+    }
+
+    /**
+     * @brief Close the queue and wake every blocked consumer.
+     *
+     * Values already queued can still be popped.
+     */
+    void close() {
+        done_.store(true);
+        seq_.fetch_add(1);
+        futex_wake(seq_, INT_MAX);
+    }
+
+    /**
+     * @brief Approximate emptiness check.
+     */
+    bool empty() const {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Approximate number of queued elements (for monitoring).
+     */
+    size_t size() const {
+        return static_cast<size_t>(local_.size() + injected_.load(std::memory_order_relaxed));
+    }
+};
+
+#endif // __LOCK_FREE_TASK_QUEUE_HPP__
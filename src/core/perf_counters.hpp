@@ -0,0 +1,467 @@
+#ifndef __PERF_COUNTERS_HPP__
+#define __PERF_COUNTERS_HPP__
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <ostream>
+#include <iomanip>
+#include <algorithm>
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "task_profiler.hpp"
+
+/**
+ * @file perf_counters.hpp
+ * @brief Per-tag hardware performance counters read around task execution.
+ *
+ * Durations tell which task classes are slow, not why. With counting enabled,
+ * each worker opens one `perf_event_open` group for its own thread (cycles,
+ * instructions, last-level cache misses, data TLB misses) and reads it before
+ * and after every task; the differences are summed per worker and per tag, so
+ * a `CounterReport` can show IPC and misses per task of each class.
+ *
+ * @details
+ * - Counting is off by default and costs nothing until enabled; when on, each
+ *   task pays two `read` system calls on the group leader.
+ * - Only user-space events of the calling thread are counted, which is allowed
+ *   at the default `perf_event_paranoid` level of 2.
+ * - Hardware counters are often missing (virtual machines, containers, seccomp
+ *   filters). A worker that cannot open the group stops trying, and the report
+ *   says why; events other than cycles that fail to open are left out.
+ * - The group is scheduled as a unit, so all values of one read cover the same
+ *   interval. Multiplexing with other perf users is not scaled for.
+ *
+ * @author dssregi
+ * @version 1.0
+ * @date 2025-11-14
+ */
+
+/**
+ * @brief Hardware events in a worker's counter group, in group order.
+ */
+enum class PerfEvent : int {
+    cycles = 0,        ///< CPU cycles (group leader).
+    instructions,      ///< Retired instructions.
+    llc_misses,        ///< Last-level cache read misses.
+    dtlb_misses,       ///< Data TLB read misses.
+    count
+};
+
+/**
+ * @brief Number of events in a counter group.
+ */
+inline constexpr int PERF_EVENTS = static_cast<int>(PerfEvent::count);
+
+/**
+ * @brief One reading (or difference of readings) of every event in a group.
+ */
+using PerfValues = std::array<uint64_t, PERF_EVENTS>;
+
+/**
+ * @brief A perf_event_open group counting the calling thread's user-space events.
+ *
+ * @thread_safety Open, read and destroy from one thread at a time; the counters
+ *                follow the thread that opened the group.
+ */
+class PerfCounterGroup {
+private:
+    /**
+     * @brief Event descriptors in group order, -1 for events that failed to open.
+     */
+    std::array<int, PERF_EVENTS> fds_;
+
+    /**
+     * @brief Group position of each event's value in a `PERF_FORMAT_GROUP` read, or -1.
+     */
+    std::array<int, PERF_EVENTS> slot_;
+
+    /**
+     * @brief Number of events opened.
+     */
+    int members_ = 0;
+
+    static long perf_event_open(perf_event_attr* attr, int group_fd) {
+        return ::syscall(SYS_perf_event_open, attr, 0, -1, group_fd, PERF_FLAG_FD_CLOEXEC);
+    }
+
+    static perf_event_attr attributes(PerfEvent event) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+
+        constexpr uint64_t read_miss = (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        switch (event) {
+        case PerfEvent::cycles:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PerfEvent::instructions:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PerfEvent::llc_misses:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_LL | read_miss;
+            break;
+        default:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_DTLB | read_miss;
+            break;
+        }
+        return attr;
+    }
+
+public:
+    PerfCounterGroup() {
+        fds_.fill(-1);
+        slot_.fill(-1);
+    }
+
+    /**
+     * @brief Close every event.
+     */
+    ~PerfCounterGroup() {
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+    }
+
+    /**
+     * @brief Disable copy construction.
+     */
+    PerfCounterGroup(const PerfCounterGroup&) = delete;
+
+    /**
+     * @brief Disable copy assignment.
+     */
+    PerfCounterGroup& operator =(const PerfCounterGroup&) = delete;
+
+    /**
+     * @brief Open the group for the calling thread; counting starts immediately.
+     *
+     * @return 0 on success, or the errno of the failed leader (cycles) open.
+     */
+    int open() {
+        for (int e = 0; e < PERF_EVENTS; ++e) {
+            perf_event_attr attr = attributes(static_cast<PerfEvent>(e));
+            const long fd = perf_event_open(&attr, e == 0 ? -1 : fds_[0]);
+            if (fd < 0) {
+                if (e == 0) {
+                    return errno;
+                }
+                continue;
+            }
+            fds_[e] = static_cast<int>(fd);
+            slot_[e] = members_++;
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Whether the group leader is open.
+     */
+    bool is_open() const {
+        return fds_[0] >= 0;
+    }
+
+    /**
+     * @brief Whether @p event is counted (its values are zero otherwise).
+     */
+    bool counts(PerfEvent event) const {
+        return fds_[static_cast<int>(event)] >= 0;
+    }
+
+    /**
+     * @brief Read every event with one system call.
+     *
+     * @param[out] values Current totals; events that are not counted read as zero.
+     * @return true on success.
+     */
+    bool read(PerfValues& values) const {
+        uint64_t buffer[1 + PERF_EVENTS];
+        const ssize_t bytes = ::read(fds_[0], buffer, sizeof(uint64_t) * (1 + members_));
+        if (bytes != static_cast<ssize_t>(sizeof(uint64_t) * (1 + members_))) {
+            return false;
+        }
+        for (int e = 0; e < PERF_EVENTS; ++e) {
+            values[e] = slot_[e] >= 0 ? buffer[1 + slot_[e]] : 0;
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief Per-tag counter totals of all tags observed by a pool.
+ */
+struct CounterReport {
+    /**
+     * @brief Totals of one tag.
+     */
+    struct Entry {
+        std::string tag;            ///< Tag name.
+        uint64_t tasks = 0;         ///< Counted tasks.
+        PerfValues totals{};        ///< Event totals over those tasks.
+
+        /**
+         * @brief Instructions per cycle.
+         */
+        double ipc() const {
+            const uint64_t cycles = totals[static_cast<int>(PerfEvent::cycles)];
+            return cycles ? double(totals[static_cast<int>(PerfEvent::instructions)]) / double(cycles) : 0.0;
+        }
+
+        /**
+         * @brief Mean count of @p event per task.
+         */
+        double per_task(PerfEvent event) const {
+            return tasks ? double(totals[static_cast<int>(event)]) / double(tasks) : 0.0;
+        }
+    };
+
+    /**
+     * @brief Whether at least one worker could open its counter group.
+     */
+    bool available = false;
+
+    /**
+     * @brief Why the counters could not be opened, if they could not.
+     */
+    std::string error;
+
+    /**
+     * @brief Events each entry has data for (some CPUs lack cache or TLB events).
+     */
+    std::array<bool, PERF_EVENTS> counted{};
+
+    /**
+     * @brief One entry per tag with counted tasks, most cycles first.
+     */
+    std::vector<Entry> entries;
+
+    /**
+     * @brief Print the report as a table of per-task means.
+     */
+    friend std::ostream& operator <<(std::ostream& os, const CounterReport& report) {
+        if (!report.available) {
+            return os << "Counter report: hardware counters unavailable ("
+                      << (report.error.empty() ? "no task was counted yet" : report.error) << ")\n";
+        }
+
+        auto column = [&](PerfEvent event, double value) {
+            if (report.counted[static_cast<int>(event)]) {
+                os << std::setw(10) << value;
+            } else {
+                os << std::setw(10) << "n/a";
+            }
+        };
+
+        os << "Counter report (means per task)\n"
+           << "  " << std::left << std::setw(32) << "tag" << std::right << std::setw(8) << "tasks"
+           << std::setw(12) << "cycles" << std::setw(6) << "IPC" << std::setw(10) << "LLC miss"
+           << std::setw(10) << "dTLB miss" << '\n';
+        os << std::fixed;
+        for (const CounterReport::Entry& e : report.entries) {
+            os << "  " << std::left << std::setw(32) << e.tag << std::right << std::setw(8) << e.tasks
+               << std::setprecision(0) << std::setw(12) << e.per_task(PerfEvent::cycles);
+            if (report.counted[static_cast<int>(PerfEvent::instructions)]) {
+                os << std::setprecision(2) << std::setw(6) << e.ipc();
+            } else {
+                os << std::setw(6) << "n/a";
+            }
+            os << std::setprecision(1);
+            column(PerfEvent::llc_misses, e.per_task(PerfEvent::llc_misses));
+            column(PerfEvent::dtlb_misses, e.per_task(PerfEvent::dtlb_misses));
+            os << '\n';
+        }
+        os.unsetf(std::ios::floatfield);
+        return os;
+    }
+};
+
+/**
+ * @brief Per-worker counter groups and per-worker, per-tag counter totals.
+ *
+ * @details
+ * A worker opens its group the first time it runs a task while counting is on,
+ * since a group can only follow the thread that opened it. Totals are plain
+ * relaxed atomics written only by their worker, as in `TaskProfiler`.
+ *
+ * @thread_safety `begin(worker, ...)` and `record(worker, ...)` must only be
+ *                called by worker `worker`. All other methods are safe to call
+ *                from any thread.
+ */
+class TaskCounterProfiler {
+private:
+    /**
+     * @brief Totals per tag: the task count followed by one total per event.
+     */
+    static constexpr int FIELDS = 1 + PERF_EVENTS;
+
+    /**
+     * @brief Whether tasks are currently counted.
+     */
+    std::atomic<bool> enabled_{false};
+
+    /**
+     * @brief Number of workers.
+     */
+    int workers_ = 0;
+
+    /**
+     * @brief Counter group of each worker, touched only by that worker.
+     */
+    std::unique_ptr<PerfCounterGroup[]> groups_;
+
+    /**
+     * @brief Whether each worker has tried to open its group.
+     */
+    std::unique_ptr<bool[]> tried_;
+
+    /**
+     * @brief Totals, indexed `(worker * MAX_TAGS + tag id) * FIELDS + field`.
+     */
+    std::unique_ptr<std::atomic<uint64_t>[]> totals_;
+
+    /**
+     * @brief Workers whose group opened.
+     */
+    std::atomic<int> opened_{0};
+
+    /**
+     * @brief Events counted by at least one worker, one bit per event.
+     */
+    std::atomic<unsigned> counted_mask_{0};
+
+    /**
+     * @brief errno of the last failed open, 0 if none failed.
+     */
+    std::atomic<int> open_error_{0};
+
+public:
+    /**
+     * @brief Construct a profiler for @p workers worker threads.
+     */
+    explicit TaskCounterProfiler(int workers)
+        : workers_(workers),
+          groups_(std::make_unique<PerfCounterGroup[]>(workers)),
+          tried_(std::make_unique<bool[]>(workers)),
+          totals_(std::make_unique<std::atomic<uint64_t>[]>(size_t(workers) * TaskTag::MAX_TAGS * FIELDS)) {}
+
+    /**
+     * @brief Disable copy construction.
+     */
+    TaskCounterProfiler(const TaskCounterProfiler&) = delete;
+
+    /**
+     * @brief Disable copy assignment.
+     */
+    TaskCounterProfiler& operator =(const TaskCounterProfiler&) = delete;
+
+    /**
+     * @brief Turn counting on or off. Totals recorded so far are kept.
+     */
+    void set_enabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+
+    /**
+     * @brief Check whether counting is on.
+     */
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Read worker @p worker's counters before a task, opening its group
+     *        on first use (called by worker @p worker only).
+     *
+     * @param[out] start Counter values to pass to `record`.
+     * @return false if this worker has no usable counters.
+     */
+    bool begin(int worker, PerfValues& start) {
+        PerfCounterGroup& group = groups_[worker];
+        if (!tried_[worker]) {
+            tried_[worker] = true;
+            if (int error = group.open(); error != 0) {
+                open_error_.store(error, std::memory_order_relaxed);
+                return false;
+            }
+            unsigned mask = 0;
+            for (int e = 0; e < PERF_EVENTS; ++e) {
+                mask |= group.counts(static_cast<PerfEvent>(e)) ? 1u << e : 0u;
+            }
+            counted_mask_.fetch_or(mask, std::memory_order_relaxed);
+            opened_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return group.is_open() && group.read(start);
+    }
+
+    /**
+     * @brief Read the counters again after a task and add the difference to
+     *        @p tag's totals (called by worker @p worker only).
+     */
+    void record(int worker, const TaskTag& tag, const PerfValues& start) {
+        PerfValues end;
+        if (!groups_[worker].read(end)) {
+            return;
+        }
+
+        std::atomic<uint64_t>* fields = &totals_[(size_t(worker) * TaskTag::MAX_TAGS + tag.id()) * FIELDS];
+        auto add = [](std::atomic<uint64_t>& field, uint64_t delta) {
+            field.store(field.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+        };
+        add(fields[0], 1);
+        for (int e = 0; e < PERF_EVENTS; ++e) {
+            add(fields[1 + e], end[e] - start[e]);
+        }
+    }
+
+    /**
+     * @brief Merge every worker's totals into a report.
+     */
+    CounterReport report() const {
+        CounterReport report;
+        report.available = opened_.load(std::memory_order_relaxed) > 0;
+        if (int error = open_error_.load(std::memory_order_relaxed); error != 0) {
+            report.error = std::string("perf_event_open: ") + std::strerror(error);
+        }
+        const unsigned mask = counted_mask_.load(std::memory_order_relaxed);
+        for (int e = 0; e < PERF_EVENTS; ++e) {
+            report.counted[e] = (mask >> e) & 1u;
+        }
+
+        for (int id = 0; id < TaskTag::MAX_TAGS; ++id) {
+            CounterReport::Entry entry;
+            for (int w = 0; w < workers_; ++w) {
+                const std::atomic<uint64_t>* fields = &totals_[(size_t(w) * TaskTag::MAX_TAGS + id) * FIELDS];
+                entry.tasks += fields[0].load(std::memory_order_relaxed);
+                for (int e = 0; e < PERF_EVENTS; ++e) {
+                    entry.totals[e] += fields[1 + e].load(std::memory_order_relaxed);
+                }
+            }
+            if (entry.tasks == 0) {
+                continue;
+            }
+            const TaskTag* tag = TaskTag::find(id);
+            entry.tag = tag ? tag->name() : "(unknown)";
+            report.entries.push_back(entry);
+        }
+
+        std::sort(report.entries.begin(), report.entries.end(), [](const auto& a, const auto& b) {
+            return a.totals[0] > b.totals[0];
+        });
+        return report;
+    }
+};
+
+#endif // __PERF_COUNTERS_HPP__
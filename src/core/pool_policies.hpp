@@ -0,0 +1,136 @@
+#ifndef __POOL_POLICIES_HPP__
+#define __POOL_POLICIES_HPP__
+
+#include <chrono>
+#include <cstdint>
+
+#include "thread_safe_deque.hpp"
+#include "lock_free_task_queue.hpp"
+
+/**
+ * @file pool_policies.hpp
+ * @brief Strategy policies plugged into `BasicThreadPool`.
+ *
+ * The pool's scheduling loop is fixed; three decisions inside it are
+ * compile-time policies, so a variant tuned for one workload costs nothing
+ * in another:
+ *
+ * @details
+ * - **QueuePolicy** chooses the per-worker task queue: `type<T>` must offer
+ *   `push`, `try_pop`, `try_steal_if`, `wait_and_pop`, `wait_and_pop_until`
+ *   and `close` with `ThreadSafeDeque`'s semantics.
+ * - **IdlePolicy** decides what a worker does once a full sweep found nothing:
+ *   `SPIN_SWEEPS` extra sweeps before parking, whether it parks at all (`PARK`;
+ *   if false it sweeps forever) and the kernel timer slack applied to
+ *   the workers' timed waits (`TIMER_SLACK`, zero keeps the default).
+ * - **VictimPolicy** is a per-worker object constructed from a seed; `next(count)`
+ *   returns the index of the next peer to steal from.
+ *
+ * @author dssregi
+ * @version 1.0
+ * @date 2025-11-14
+ */
+
+/**
+ * @brief Queue policy: mutex-protected, bounded `ThreadSafeDeque` (blocks producers when full).
+ */
+struct MutexDequeQueue {
+    template <class T>
+    using type = ThreadSafeDeque<T>;
+};
+
+/**
+ * @brief Queue policy: unbounded `LockFreeTaskQueue` (Chase-Lev deque plus injection
+ *        queue) with futex parking.
+ */
+struct LockFreeQueue {
+    template <class T>
+    using type = LockFreeTaskQueue<T>;
+};
+
+/**
+ * @brief Idle policy: park as soon as a sweep finds no work.
+ */
+struct ParkWhenIdle {
+    static constexpr int SPIN_SWEEPS = 0;
+    static constexpr bool PARK = true;
+    static constexpr std::chrono::nanoseconds TIMER_SLACK{0};
+};
+
+/**
+ * @brief Idle policy: keep sweeping for @p Sweeps rounds before parking.
+ *
+ * Work submitted during the spin is picked up without a wake-up, at the
+ * price of burning a core for a few microseconds after every burst.
+ */
+template <int Sweeps = 256>
+struct SpinThenPark {
+    static constexpr int SPIN_SWEEPS = Sweeps;
+    static constexpr bool PARK = true;
+    static constexpr std::chrono::nanoseconds TIMER_SLACK{0};
+};
+
+/**
+ * @brief Idle policy: park immediately and let the kernel batch wake-ups.
+ *
+ * A 1 ms timer slack lets the kernel coalesce the time keeper's timeouts with
+ * other timers.
+ */
+struct LowPowerIdle {
+    static constexpr int SPIN_SWEEPS = 0;
+    static constexpr bool PARK = true;
+    static constexpr std::chrono::nanoseconds TIMER_SLACK{1000000};
+};
+
+/**
+ * @brief Idle policy: never park; sweep continuously with a `pause` between sweeps.
+ *
+ * Submit-to-start latency is one sweep, with no wake-up on any path, but
+ * every worker occupies its core at 100% for the lifetime of the pool. Meant
+ * for workers pinned to isolated cores (`WorkerOptions::cpus`). Timers and
+ * in-flight I/O are serviced on every sweep.
+ */
+struct BusyPoll {
+    static constexpr int SPIN_SWEEPS = 0;
+    static constexpr bool PARK = false;
+    static constexpr std::chrono::nanoseconds TIMER_SLACK{0};
+};
+
+/**
+ * @brief Victim policy: uniformly random peers from a per-worker xorshift generator.
+ */
+class RandomVictim {
+private:
+    uint32_t state_;
+
+public:
+    explicit RandomVictim(uint32_t seed) : state_(seed * 0x9E3779B9u + 1) {}
+
+    int next(int count) {
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 17;
+        state_ ^= state_ << 5;
+        return static_cast<int>(state_ % static_cast<uint32_t>(count));
+    }
+};
+
+/**
+ * @brief Victim policy: visit peers in order, starting after the worker's own index.
+ *
+ * Every peer is probed once per `count` sweeps, which bounds how long queued
+ * work can go unnoticed while a worker spins.
+ */
+class RoundRobinVictim {
+private:
+    uint32_t cursor_;
+
+public:
+    explicit RoundRobinVictim(uint32_t seed) : cursor_(seed) {}
+
+    int next(int count) {
+        cursor_ = cursor_ + 1 >= static_cast<uint32_t>(count) ? 0 : cursor_ + 1;
+        return static_cast<int>(cursor_);
+    }
+};
+
+#endif // __POOL_POLICIES_HPP__
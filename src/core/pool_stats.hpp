@@ -0,0 +1,350 @@
+#ifndef __POOL_STATS_HPP__
+#define __POOL_STATS_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cerrno>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @file pool_stats.hpp
+ * @brief Per-worker scheduler counters and their shared-memory publication.
+ *
+ * Every worker keeps a few monotonically increasing counters (tasks run,
+ * steals, parks, time parked). A pool asked to `publish_stats` copies them,
+ * together with queue depths and parked flags, into a POSIX shared-memory
+ * segment at a fixed interval, where any process can read them without
+ * stopping or attaching to the pool; `src/tools/wsp_top.cpp` is such a reader.
+ *
+ * @details
+ * - The segment is a `StatsSegmentHeader` followed by one `SharedWorkerStats`
+ *   per worker. Its layout is versioned; readers check `magic` and `version`.
+ * - Consistency uses a seqlock: the publisher makes `seq` odd, stores every
+ *   field, then makes it even again. Readers copy everything and retry if
+ *   `seq` was odd or changed meanwhile. Readers never block the publisher.
+ * - All shared fields are lock-free atomics, so the cross-process accesses are
+ *   race-free, and readers may map the segment read-only.
+ *
+ * @author dssregi
+ * @version 1.0
+ * @date 2025-11-14
+ */
+
+/**
+ * @brief Scheduler counters of one worker, written only by that worker.
+ */
+struct alignas(64) WorkerCounters {
+    std::atomic<uint64_t> tasks{0};           ///< Tasks executed.
+    std::atomic<uint64_t> steals{0};          ///< Successful steals from peer queues.
+    std::atomic<uint64_t> failed_steals{0};   ///< Steal attempts that found nothing.
+    std::atomic<uint64_t> parks{0};           ///< Times the worker blocked on its queue.
+    std::atomic<uint64_t> parked_ns{0};       ///< Total time spent blocked in completed parks.
+    std::atomic<uint64_t> park_started{0};    ///< `monotonic_ns()` at the start of the current park, or 0.
+
+    /**
+     * @brief Add @p delta to a counter (single writer, so no read-modify-write needed).
+     */
+    static void add(std::atomic<uint64_t>& counter, uint64_t delta = 1) {
+        counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief Segment identification: "WSPS".
+ */
+inline constexpr uint32_t STATS_SEGMENT_MAGIC = 0x53505357;
+
+/**
+ * @brief Layout version of the segment.
+ */
+inline constexpr uint32_t STATS_SEGMENT_VERSION = 2;
+
+/**
+ * @brief Fixed-size header at the start of a stats segment.
+ */
+struct alignas(64) StatsSegmentHeader {
+    std::atomic<uint32_t> magic;           ///< `STATS_SEGMENT_MAGIC` once initialized.
+    std::atomic<uint32_t> version;         ///< `STATS_SEGMENT_VERSION`.
+    std::atomic<uint32_t> workers;         ///< Number of `SharedWorkerStats` entries.
+    std::atomic<int32_t> pid;              ///< Publishing process.
+    std::atomic<uint64_t> seq;             ///< Seqlock sequence; odd while a snapshot is written.
+    std::atomic<uint64_t> published_ns;    ///< `CLOCK_MONOTONIC` time of the last snapshot.
+    std::atomic<uint64_t> snapshots;       ///< Number of snapshots published.
+};
+
+/**
+ * @brief One worker's entry in a stats segment.
+ */
+struct alignas(64) SharedWorkerStats {
+    std::atomic<uint64_t> tasks;           ///< Tasks executed.
+    std::atomic<uint64_t> steals;          ///< Successful steals.
+    std::atomic<uint64_t> failed_steals;   ///< Steal attempts that found nothing.
+    std::atomic<uint64_t> parks;           ///< Times parked.
+    std::atomic<uint64_t> parked_ns;       ///< Total time parked, including a park in progress.
+    std::atomic<uint64_t> queued;          ///< Tasks waiting in the worker's queues.
+    std::atomic<uint64_t> long_tasks;      ///< Tasks over the watchdog threshold.
+    std::atomic<uint32_t> parked;          ///< 1 while the worker is parked.
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+              "shared-memory counters must be address-free atomics");
+
+/**
+ * @brief Plain copy of one worker's entry, as returned to readers.
+ */
+struct WorkerStatsSnapshot {
+    uint64_t tasks = 0;
+    uint64_t steals = 0;
+    uint64_t failed_steals = 0;
+    uint64_t parks = 0;
+    uint64_t parked_ns = 0;
+    uint64_t queued = 0;
+    uint64_t long_tasks = 0;
+    bool parked = false;
+};
+
+/**
+ * @brief Consistent copy of a whole stats segment.
+ */
+struct PoolStatsSnapshot {
+    int pid = 0;                                   ///< Publishing process.
+    uint64_t published_ns = 0;                     ///< `CLOCK_MONOTONIC` time of the snapshot.
+    uint64_t snapshots = 0;                        ///< Snapshot counter.
+    std::vector<WorkerStatsSnapshot> workers;      ///< One entry per worker.
+};
+
+/**
+ * @brief Current `CLOCK_MONOTONIC` time in nanoseconds (comparable across processes).
+ */
+inline uint64_t monotonic_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * @brief Bytes needed for a segment with @p workers entries.
+ */
+inline size_t stats_segment_bytes(int workers) {
+    return sizeof(StatsSegmentHeader) + sizeof(SharedWorkerStats) * static_cast<size_t>(workers);
+}
+
+/**
+ * @brief Writable stats segment owned by the publishing pool.
+ *
+ * @thread_safety `publish` must not be called concurrently with itself.
+ */
+class StatsSegment {
+private:
+    std::string name_;
+    StatsSegmentHeader* header_ = nullptr;
+    size_t bytes_ = 0;
+
+    SharedWorkerStats* entries() {
+        return reinterpret_cast<SharedWorkerStats*>(header_ + 1);
+    }
+
+public:
+    /**
+     * @brief Create (or replace) the shared-memory object @p name and initialize it.
+     *
+     * @param name POSIX shared-memory name, e.g. "/wsp-demo" (`/dev/shm/wsp-demo`).
+     * @param workers Number of worker entries.
+     * @throws std::system_error if the object cannot be created or mapped.
+     */
+    StatsSegment(std::string name, int workers) : name_(std::move(name)), bytes_(stats_segment_bytes(workers)) {
+        const int fd = ::shm_open(name_.c_str(), O_CREAT | O_RDWR | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            throw std::system_error(errno, std::system_category(), "shm_open " + name_);
+        }
+        if (::ftruncate(fd, static_cast<off_t>(bytes_)) != 0) {
+            const int error = errno;
+            ::close(fd);
+            ::shm_unlink(name_.c_str());
+            throw std::system_error(error, std::system_category(), "ftruncate " + name_);
+        }
+        void* map = ::mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        const int error = errno;
+        ::close(fd);
+        if (map == MAP_FAILED) {
+            ::shm_unlink(name_.c_str());
+            throw std::system_error(error, std::system_category(), "mmap " + name_);
+        }
+
+        // The zero-filled object is a valid all-zero state for every atomic;
+        // publishing the magic last tells readers the header is complete.
+        header_ = static_cast<StatsSegmentHeader*>(map);
+        header_->version.store(STATS_SEGMENT_VERSION, std::memory_order_relaxed);
+        header_->workers.store(static_cast<uint32_t>(workers), std::memory_order_relaxed);
+        header_->pid.store(static_cast<int32_t>(::getpid()), std::memory_order_relaxed);
+        header_->magic.store(STATS_SEGMENT_MAGIC, std::memory_order_release);
+    }
+
+    /**
+     * @brief Unmap and remove the shared-memory object.
+     */
+    ~StatsSegment() {
+        ::munmap(header_, bytes_);
+        ::shm_unlink(name_.c_str());
+    }
+
+    /**
+     * @brief Disable copy construction.
+     */
+    StatsSegment(const StatsSegment&) = delete;
+
+    /**
+     * @brief Disable copy assignment.
+     */
+    StatsSegment& operator =(const StatsSegment&) = delete;
+
+    /**
+     * @brief Name of the shared-memory object.
+     */
+    const std::string& name() const {
+        return name_;
+    }
+
+    /**
+     * @brief Write one snapshot under the seqlock.
+     *
+     * @param fill Called as `fill(int worker, WorkerStatsSnapshot& out)` for every worker.
+     */
+    template <class F>
+    void publish(F&& fill) {
+        const uint64_t seq = header_->seq.load(std::memory_order_relaxed);
+        header_->seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        const int workers = static_cast<int>(header_->workers.load(std::memory_order_relaxed));
+        SharedWorkerStats* out = entries();
+        for (int w = 0; w < workers; ++w) {
+            WorkerStatsSnapshot s;
+            fill(w, s);
+            out[w].tasks.store(s.tasks, std::memory_order_relaxed);
+            out[w].steals.store(s.steals, std::memory_order_relaxed);
+            out[w].failed_steals.store(s.failed_steals, std::memory_order_relaxed);
+            out[w].parks.store(s.parks, std::memory_order_relaxed);
+            out[w].parked_ns.store(s.parked_ns, std::memory_order_relaxed);
+            out[w].queued.store(s.queued, std::memory_order_relaxed);
+            out[w].long_tasks.store(s.long_tasks, std::memory_order_relaxed);
+            out[w].parked.store(s.parked ? 1 : 0, std::memory_order_relaxed);
+        }
+        header_->published_ns.store(monotonic_ns(), std::memory_order_relaxed);
+        header_->snapshots.store(header_->snapshots.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+        header_->seq.store(seq + 2, std::memory_order_release);
+    }
+};
+
+/**
+ * @brief Read-only view of a stats segment published by another process.
+ *
+ * @thread_safety `snapshot` may be called from any thread.
+ */
+class StatsReader {
+private:
+    const StatsSegmentHeader* header_ = nullptr;
+    size_t bytes_ = 0;
+
+    const SharedWorkerStats* entries() const {
+        return reinterpret_cast<const SharedWorkerStats*>(header_ + 1);
+    }
+
+public:
+    /**
+     * @brief Map the shared-memory object @p name read-only.
+     *
+     * @throws std::system_error if it does not exist, cannot be mapped, or is
+     *         not a stats segment of a supported version.
+     */
+    explicit StatsReader(const std::string& name) {
+        const int fd = ::shm_open(name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+        if (fd < 0) {
+            throw std::system_error(errno, std::system_category(), "shm_open " + name);
+        }
+        struct stat info {};
+        if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(StatsSegmentHeader)) {
+            ::close(fd);
+            throw std::system_error(EINVAL, std::system_category(), name + " is not a stats segment");
+        }
+        bytes_ = static_cast<size_t>(info.st_size);
+        void* map = ::mmap(nullptr, bytes_, PROT_READ, MAP_SHARED, fd, 0);
+        const int error = errno;
+        ::close(fd);
+        if (map == MAP_FAILED) {
+            throw std::system_error(error, std::system_category(), "mmap " + name);
+        }
+        header_ = static_cast<const StatsSegmentHeader*>(map);
+
+        if (header_->magic.load(std::memory_order_acquire) != STATS_SEGMENT_MAGIC ||
+            header_->version.load(std::memory_order_relaxed) != STATS_SEGMENT_VERSION ||
+            stats_segment_bytes(static_cast<int>(header_->workers.load(std::memory_order_relaxed))) > bytes_) {
+            ::munmap(const_cast<StatsSegmentHeader*>(header_), bytes_);
+            throw std::system_error(EINVAL, std::system_category(), name + " is not a supported stats segment");
+        }
+    }
+
+    /**
+     * @brief Unmap the segment.
+     */
+    ~StatsReader() {
+        ::munmap(const_cast<StatsSegmentHeader*>(header_), bytes_);
+    }
+
+    /**
+     * @brief Disable copy construction.
+     */
+    StatsReader(const StatsReader&) = delete;
+
+    /**
+     * @brief Disable copy assignment.
+     */
+    StatsReader& operator =(const StatsReader&) = delete;
+
+    /**
+     * @brief Copy a consistent snapshot, retrying while the publisher is writing.
+     */
+    PoolStatsSnapshot snapshot() const {
+        PoolStatsSnapshot snap;
+        const int workers = static_cast<int>(header_->workers.load(std::memory_order_relaxed));
+        snap.workers.resize(workers);
+
+        while (true) {
+            const uint64_t before = header_->seq.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue;
+            }
+
+            snap.pid = header_->pid.load(std::memory_order_relaxed);
+            snap.published_ns = header_->published_ns.load(std::memory_order_relaxed);
+            snap.snapshots = header_->snapshots.load(std::memory_order_relaxed);
+            const SharedWorkerStats* in = entries();
+            for (int w = 0; w < workers; ++w) {
+                WorkerStatsSnapshot& s = snap.workers[w];
+                s.tasks = in[w].tasks.load(std::memory_order_relaxed);
+                s.steals = in[w].steals.load(std::memory_order_relaxed);
+                s.failed_steals = in[w].failed_steals.load(std::memory_order_relaxed);
+                s.parks = in[w].parks.load(std::memory_order_relaxed);
+                s.parked_ns = in[w].parked_ns.load(std::memory_order_relaxed);
+                s.queued = in[w].queued.load(std::memory_order_relaxed);
+                s.long_tasks = in[w].long_tasks.load(std::memory_order_relaxed);
+                s.parked = in[w].parked.load(std::memory_order_relaxed) != 0;
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (header_->seq.load(std::memory_order_relaxed) == before) {
+                return snap;
+            }
+        }
+    }
+};
+
+#endif // __POOL_STATS_HPP__
@@ -0,0 +1,144 @@
+#ifndef __SPIN_BARRIER_HPP__
+#define __SPIN_BARRIER_HPP__
+
+#include <atomic>
+#include <thread>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @file spin_barrier.hpp
+ * @brief Sense-reversing barrier that spins briefly, then parks.
+ *
+ * SPMD phases (`ThreadPool::run_spmd`) need a barrier that costs little more
+ * than one cache-line round trip when all participants arrive close together,
+ * yet does not burn a core when one of them is late.
+ *
+ * @details
+ * - Centralized sense-reversing design: participants decrement a shared count;
+ *   the last one to arrive resets it and flips the phase word, releasing the rest.
+ * - Waiters first spin on the phase word (with a CPU pause hint) for a bounded
+ *   number of iterations, then block in `std::atomic::wait` (a futex on Linux).
+ *   The releaser only issues the wake-up system call if someone actually parked.
+ *
+ * @author dssregi
+ * @version 1.0
+ * @date 2025-11-14
+ */
+
+/**
+ * @brief Hint to the CPU that the caller is spin-waiting.
+ */
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+/**
+ * @brief Reusable barrier for a fixed number of participants.
+ *
+ * @thread_safety `arrive_and_wait` is called concurrently by exactly
+ *                `participants` threads per phase.
+ */
+class SpinBarrier {
+private:
+    /**
+     * @brief Number of threads taking part in every phase.
+     */
+    const int participants_;
+
+    /**
+     * @brief Spin iterations before a waiter parks.
+     */
+    const int spin_limit_;
+
+    /**
+     * @brief Threads still to arrive in the current phase.
+     */
+    alignas(64) std::atomic<int> remaining_;
+
+    /**
+     * @brief Phase counter; flipping it releases the waiters ("sense").
+     */
+    alignas(64) std::atomic<uint32_t> phase_{0};
+
+    /**
+     * @brief Number of waiters blocked (or about to block) in `atomic::wait`.
+     *
+     * Each waiter decrements it itself once released, so a count belonging to
+     * the next phase can never be lost by the releaser of the current one.
+     */
+    std::atomic<int> parked_{0};
+
+public:
+    /**
+     * @brief Create a barrier.
+     *
+     * @param participants Number of threads that must arrive to complete a phase.
+     * @param spin_limit Spin iterations before a waiter parks (0 parks at once).
+     */
+    explicit SpinBarrier(int participants, int spin_limit = 4000)
+        : participants_(participants), spin_limit_(spin_limit), remaining_(participants) {}
+
+    /**
+     * @brief Disable copy construction.
+     */
+    SpinBarrier(const SpinBarrier&) = delete;
+
+    /**
+     * @brief Disable copy assignment.
+     */
+    SpinBarrier& operator =(const SpinBarrier&) = delete;
+
+    /**
+     * @brief Block until all participants have arrived at this phase.
+     *
+     * Memory effects of every participant before the call are visible to every
+     * participant after it returns.
+     */
+    void arrive_and_wait() {
+        const uint32_t phase = phase_.load(std::memory_order_relaxed);
+
+        if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            // Last arrival: reset for the next phase, then release everybody.
+            // The phase store and the parked_ load are sequentially consistent, so
+            // either a parking waiter sees the new phase or we see it parked.
+            remaining_.store(participants_, std::memory_order_relaxed);
+            phase_.store(phase + 1);
+            if (parked_.load() > 0) {
+                phase_.notify_all();
+            }
+            return;
+        }
+
+        for (int spin = 0; spin < spin_limit_; ++spin) {
+            if (phase_.load(std::memory_order_acquire) != phase) {
+                return;
+            }
+            cpu_relax();
+        }
+
+        parked_.fetch_add(1);
+        while (phase_.load() == phase) {
+            phase_.wait(phase, std::memory_order_acquire);
+        }
+        parked_.fetch_sub(1);
+    }
+
+    /**
+     * @brief Number of participants per phase.
+     */
+    int participants() const {
+        return participants_;
+    }
+};
+
+#endif // __SPIN_BARRIER_HPP__
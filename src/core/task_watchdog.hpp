@@ -0,0 +1,459 @@
+#ifndef __TASK_WATCHDOG_HPP__
+#define __TASK_WATCHDOG_HPP__
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <iostream>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cxxabi.h>
+#include <execinfo.h>
+#include <pthread.h>
+#include <signal.h>
+
+#include "task_profiler.hpp"
+
+/**
+ * @file task_watchdog.hpp
+ * @brief Detection of tasks that pin a worker for too long, with stack sampling.
+ *
+ * A single pathological task (an unexpected O(n^2) path, a blocking call, a
+ * livelock) occupies its worker until it returns, and everything queued behind
+ * it waits. The watchdog makes such tasks visible while they are still running:
+ * it reports the task's tag and where the worker currently is, and counts every
+ * task that exceeded the threshold so the long tail can be alerted on.
+ *
+ * @details
+ * - Workers publish the start time and tag of their current task in a
+ *   per-worker slot (seqlock-style: the sequence number is odd while a task runs).
+ * - A dedicated monitor thread scans the slots several times per threshold. It
+ *   cannot run on the pool itself: when every worker is stuck, nothing would.
+ * - To sample a stuck worker's stack, the monitor sends it `SIGRTMIN + 4`. The
+ *   handler runs `backtrace()` on the worker into a shared buffer. Symbolization
+ *   happens later in the monitor thread, outside the handler. Link with
+ *   `-rdynamic` to get function names for the executable's own frames.
+ * - The signal is installed with `SA_RESTART`, but a stuck task blocked in a
+ *   system call that is never restarted (e.g. `nanosleep`, `poll`) sees `EINTR`.
+ * - Each task is reported at most once. A task that exceeded the threshold
+ *   between two scans is still counted when it ends, but it is not sampled.
+ *
+ * @author dssregi
+ * @version 1.0
+ * @date 2025-11-14
+ */
+
+/**
+ * @brief What the watchdog knows about a task that exceeded its threshold.
+ */
+struct StuckTaskReport {
+    int worker = -1;                            ///< Worker running the task.
+    const char* tag = "untagged";               ///< Name of the task's tag.
+    std::chrono::nanoseconds running{0};        ///< How long the task had run when detected.
+    uint64_t long_tasks = 0;                    ///< Long tasks counted so far, this one included.
+    std::vector<std::string> stack;             ///< Symbolized frames, innermost first.
+    std::string stack_note;                     ///< Why `stack` is empty or may be stale, if it is.
+};
+
+/**
+ * @brief Print a report in the watchdog's log format.
+ */
+inline std::ostream& operator <<(std::ostream& os, const StuckTaskReport& report) {
+    os << "[Watchdog] Worker " << report.worker << " has been running a '" << report.tag << "' task for "
+       << std::chrono::duration_cast<std::chrono::milliseconds>(report.running).count() << " ms ("
+       << report.long_tasks << " long tasks so far)\n";
+    if (!report.stack_note.empty()) {
+        os << "  (" << report.stack_note << ")\n";
+    }
+    for (size_t i = 0; i < report.stack.size(); ++i) {
+        os << "  #" << i << ' ' << report.stack[i] << '\n';
+    }
+    return os;
+}
+
+/**
+ * @brief Callback invoked from the monitor thread for each stuck task.
+ */
+using StuckTaskHandler = std::function<void(const StuckTaskReport&)>;
+
+/**
+ * @brief Buffer a signalled worker writes its stack into.
+ *
+ * `state` moves idle -> requested (monitor) -> writing -> done (handler) ->
+ * idle (monitor); only one sample is in flight at a time.
+ */
+struct StackSample {
+    /**
+     * @brief Maximum number of frames captured per sample.
+     */
+    static constexpr int MAX_FRAMES = 48;
+
+    enum State : int { IDLE, REQUESTED, WRITING, DONE };
+    std::atomic<int> state{IDLE};
+    void* frames[MAX_FRAMES];
+    int depth = 0;
+};
+
+/**
+ * @brief Per-worker task start tracking, long-task counters and the monitor thread.
+ *
+ * @thread_safety `begin`/`end` are called by the owning worker only; `start`,
+ *                `stop` and the accessors may be called from any thread.
+ */
+class TaskWatchdog {
+public:
+    /**
+     * @brief Offset from `SIGRTMIN` of the signal used to sample worker stacks.
+     */
+    static constexpr int SIGNAL_OFFSET = 4;
+
+    /**
+     * @brief How long the monitor waits for a signalled worker to take its sample.
+     */
+    static constexpr std::chrono::milliseconds SAMPLE_TIMEOUT{100};
+
+private:
+    /**
+     * @brief What one worker is running, written only by that worker.
+     */
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> seq{0};                ///< Odd while a task runs.
+        std::atomic<uint64_t> started_ns{0};         ///< Start of the current task.
+        std::atomic<const TaskTag*> tag{nullptr};    ///< Tag of the current task, or nullptr.
+        std::atomic<uint64_t> flagged_seq{0};        ///< `seq` of the last task counted as long.
+        std::atomic<uint64_t> long_tasks{0};         ///< Tasks of this worker that exceeded the threshold.
+        pthread_t thread{};                          ///< Worker thread, for stack sampling.
+    };
+
+    /**
+     * @brief Process-wide sample buffer, and the mutex serializing samples across pools.
+     */
+    inline static StackSample sample_;
+    inline static std::mutex sample_mut_;
+
+    /**
+     * @brief One-time handler installation, and whether it succeeded (false if
+     *        the application already uses the signal).
+     */
+    inline static std::once_flag handler_once_;
+    inline static bool handler_installed_ = false;
+
+    /**
+     * @brief One slot per worker.
+     */
+    std::unique_ptr<Slot[]> slots_;
+    int workers_;
+
+    /**
+     * @brief Monitoring state; `threshold_ns_` is also read by workers in `end`.
+     */
+    std::atomic<bool> enabled_{false};
+    std::atomic<uint64_t> threshold_ns_{0};
+    StuckTaskHandler handler_;
+
+    /**
+     * @brief Monitor thread, woken early only to stop.
+     */
+    std::jthread monitor_;
+    std::mutex monitor_mut_;
+    std::condition_variable_any monitor_cv_;
+
+    /**
+     * @brief Current steady-clock time in nanoseconds.
+     */
+    static uint64_t now_ns() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    /**
+     * @brief Signal handler: unwind the interrupted worker into `sample_`.
+     *
+     * Async-signal-safe once `backtrace` has been warmed up (its first call may
+     * load the unwinder library); `install_handler` does that.
+     */
+    static void on_sample_signal(int) {
+        int expected = StackSample::REQUESTED;
+        if (!sample_.state.compare_exchange_strong(expected, StackSample::WRITING)) {
+            return;
+        }
+        sample_.depth = ::backtrace(sample_.frames, StackSample::MAX_FRAMES);
+        sample_.state.store(StackSample::DONE, std::memory_order_release);
+    }
+
+    /**
+     * @brief Install the handler once per process, unless the signal is already in use.
+     */
+    static void install_handler() {
+        std::call_once(handler_once_, [] {
+            void* warm[1];
+            ::backtrace(warm, 1);
+
+            struct sigaction previous {};
+            if (::sigaction(SIGRTMIN + SIGNAL_OFFSET, nullptr, &previous) != 0 ||
+                (previous.sa_flags & SA_SIGINFO) || previous.sa_handler != SIG_DFL) {
+                return;
+            }
+            struct sigaction action {};
+            action.sa_handler = &TaskWatchdog::on_sample_signal;
+            action.sa_flags = SA_RESTART;
+            sigemptyset(&action.sa_mask);
+            handler_installed_ = ::sigaction(SIGRTMIN + SIGNAL_OFFSET, &action, nullptr) == 0;
+        });
+    }
+
+    /**
+     * @brief Count the task @p seq of @p slot as long, unless someone already did.
+     *
+     * @return true if this call counted it.
+     */
+    static bool flag(Slot& slot, uint64_t seq) {
+        uint64_t flagged = slot.flagged_seq.load(std::memory_order_relaxed);
+        if (flagged == seq || !slot.flagged_seq.compare_exchange_strong(flagged, seq)) {
+            return false;
+        }
+        slot.long_tasks.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Sample @p thread's stack and symbolize it.
+     *
+     * @return Frames innermost first, starting below the signal trampoline.
+     */
+    static std::vector<std::string> sample_stack(pthread_t thread, std::string& note) {
+        std::vector<std::string> stack;
+        if (!handler_installed_) {
+            note = "stack sampling unavailable: signal already in use";
+            return stack;
+        }
+
+        std::lock_guard<std::mutex> lock(sample_mut_);
+        sample_.state.store(StackSample::REQUESTED);
+        if (::pthread_kill(thread, SIGRTMIN + SIGNAL_OFFSET) != 0) {
+            sample_.state.store(StackSample::IDLE);
+            note = "stack sampling failed: could not signal the worker";
+            return stack;
+        }
+
+        const auto deadline = std::chrono::steady_clock::now() + SAMPLE_TIMEOUT;
+        while (sample_.state.load(std::memory_order_acquire) != StackSample::DONE) {
+            int expected = StackSample::REQUESTED;
+            if (std::chrono::steady_clock::now() > deadline &&
+                sample_.state.compare_exchange_strong(expected, StackSample::IDLE)) {
+                note = "stack sampling timed out";
+                return stack;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+
+        // Frame 0 is the handler and frame 1 the kernel's signal trampoline
+        const int skip = std::min(sample_.depth, 2);
+        char** symbols = ::backtrace_symbols(sample_.frames + skip, sample_.depth - skip);
+        for (int i = 0; symbols != nullptr && i < sample_.depth - skip; ++i) {
+            stack.push_back(demangle(symbols[i]));
+        }
+        std::free(symbols);
+        sample_.state.store(StackSample::IDLE);
+        if (stack.empty()) {
+            note = "no frames captured";
+        }
+        return stack;
+    }
+
+    /**
+     * @brief Demangle the symbol in a `backtrace_symbols` line ("module(symbol+offset) [address]").
+     */
+    static std::string demangle(const std::string& line) {
+        const size_t open = line.find('(');
+        const size_t plus = line.find('+', open);
+        if (open == std::string::npos || plus == std::string::npos || plus == open + 1) {
+            return line;
+        }
+        int status = 0;
+        const std::string mangled = line.substr(open + 1, plus - open - 1);
+        char* name = abi::__cxa_demangle(mangled.c_str(), nullptr, nullptr, &status);
+        if (status != 0 || name == nullptr) {
+            return line;
+        }
+        std::string result = line.substr(0, open + 1) + name + line.substr(plus);
+        std::free(name);
+        return result;
+    }
+
+    /**
+     * @brief Monitor loop: scan all slots several times per threshold.
+     */
+    void monitor(std::stop_token token) {
+        while (!token.stop_requested()) {
+            const uint64_t threshold = threshold_ns_.load(std::memory_order_relaxed);
+            scan(threshold);
+
+            const auto period = std::chrono::nanoseconds(std::max<uint64_t>(threshold / 4, 1000000));
+            std::unique_lock<std::mutex> lock(monitor_mut_);
+            monitor_cv_.wait_for(lock, token, period, [] { return false; });
+        }
+    }
+
+    /**
+     * @brief Report every task that has been running longer than @p threshold.
+     */
+    void scan(uint64_t threshold) {
+        for (int w = 0; w < workers_; ++w) {
+            Slot& slot = slots_[w];
+            const uint64_t seq = slot.seq.load(std::memory_order_acquire);
+            if ((seq & 1) == 0) {
+                continue;
+            }
+            const uint64_t started = slot.started_ns.load(std::memory_order_relaxed);
+            const TaskTag* tag = slot.tag.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_relaxed) != seq) {
+                continue;
+            }
+
+            const uint64_t now = now_ns();
+            if (now - started <= threshold || !flag(slot, seq)) {
+                continue;
+            }
+
+            StuckTaskReport report;
+            report.worker = w;
+            report.tag = tag ? tag->name() : TaskTag::untagged().name();
+            report.running = std::chrono::nanoseconds(now - started);
+            report.long_tasks = long_task_count();
+            report.stack = sample_stack(slot.thread, report.stack_note);
+            if (report.stack_note.empty() && slot.seq.load() != seq) {
+                report.stack_note = "the task finished before the sample; the stack may show later work";
+            }
+
+            if (handler_) {
+                handler_(report);
+            } else {
+                std::ostringstream os;
+                os << report;
+                std::cerr << os.str() << std::flush;
+            }
+        }
+    }
+
+public:
+    /**
+     * @brief Create a stopped watchdog for @p workers workers.
+     */
+    explicit TaskWatchdog(int workers) : slots_(std::make_unique<Slot[]>(workers)), workers_(workers) {}
+
+    /**
+     * @brief Stop the monitor thread.
+     */
+    ~TaskWatchdog() {
+        stop();
+    }
+
+    /**
+     * @brief Disable copy construction.
+     */
+    TaskWatchdog(const TaskWatchdog&) = delete;
+
+    /**
+     * @brief Disable copy assignment.
+     */
+    TaskWatchdog& operator =(const TaskWatchdog&) = delete;
+
+    /**
+     * @brief Record the native handle of worker @p worker (before `start`).
+     */
+    void set_thread(int worker, pthread_t thread) {
+        slots_[worker].thread = thread;
+    }
+
+    /**
+     * @brief Start (or restart) monitoring with a new threshold and handler.
+     *
+     * @param threshold Run time after which a task counts as stuck.
+     * @param handler Called from the monitor thread per stuck task; when empty,
+     *        reports are written to std::cerr.
+     */
+    void start(std::chrono::nanoseconds threshold, StuckTaskHandler handler) {
+        stop();
+        install_handler();
+        handler_ = std::move(handler);
+        threshold_ns_.store(static_cast<uint64_t>(std::max<int64_t>(threshold.count(), 1)));
+        enabled_.store(true);
+        monitor_ = std::jthread([this](std::stop_token token) { monitor(std::move(token)); });
+    }
+
+    /**
+     * @brief Stop monitoring; tasks already running are no longer tracked.
+     */
+    void stop() {
+        enabled_.store(false);
+        if (monitor_.joinable()) {
+            monitor_.request_stop();
+            monitor_.join();
+        }
+    }
+
+    /**
+     * @brief Whether workers should call `begin`/`end` around tasks.
+     */
+    bool enabled() const {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Mark the start of a task on worker @p worker.
+     */
+    void begin(int worker, const TaskTag* tag) {
+        Slot& slot = slots_[worker];
+        slot.started_ns.store(now_ns(), std::memory_order_relaxed);
+        slot.tag.store(tag, std::memory_order_relaxed);
+        slot.seq.store(slot.seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Mark the end of the task begun on worker @p worker, counting it if it was long.
+     */
+    void end(int worker) {
+        Slot& slot = slots_[worker];
+        const uint64_t seq = slot.seq.load(std::memory_order_relaxed);
+        const uint64_t elapsed = now_ns() - slot.started_ns.load(std::memory_order_relaxed);
+        slot.seq.store(seq + 1, std::memory_order_relaxed);
+        // Orders the even sequence before the next task's start time (see `scan`)
+        std::atomic_thread_fence(std::memory_order_release);
+        if (elapsed > threshold_ns_.load(std::memory_order_relaxed)) {
+            flag(slot, seq);
+        }
+    }
+
+    /**
+     * @brief Tasks of worker @p worker that exceeded the threshold while monitored.
+     */
+    uint64_t long_tasks(int worker) const {
+        return slots_[worker].long_tasks.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Tasks of all workers that exceeded the threshold while monitored.
+     */
+    uint64_t long_task_count() const {
+        uint64_t total = 0;
+        for (int w = 0; w < workers_; ++w) {
+            total += long_tasks(w);
+        }
+        return total;
+    }
+};
+
+#endif // __TASK_WATCHDOG_HPP__
@@ -0,0 +1,423 @@
+#ifndef __TENANT_SCHEDULER_HPP__
+#define __TENANT_SCHEDULER_HPP__
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <string>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <limits>
+#include <cstdint>
+#include <ostream>
+#include <iomanip>
+#include <time.h>
+
+/**
+ * @file tenant_scheduler.hpp
+ * @brief Weighted fair sharing and admission control between pool tenants.
+ *
+ * Several subsystems submitting to one pool should not be able to starve each
+ * other. Tasks submitted on behalf of a `Tenant` are not spread over the
+ * workers' deques; they wait in a per-tenant FIFO, and workers dispatch from
+ * those FIFOs with deficit round robin (DRR) over CPU time: each turn credits
+ * a tenant `weight` quanta of `QUANTUM_NS`, and it keeps dispatching until its
+ * tasks have used the credit up, so tenants receive CPU time (not task counts)
+ * in proportion to their weights.
+ *
+ * @details
+ * - Each tenant caps its in-flight tasks (submitted but not yet finished).
+ *   Submissions over the cap are either rejected or delayed until one of the
+ *   tenant's tasks finishes, depending on the tenant's `OverQuota` policy.
+ * - The CPU time of every tenant task is measured with `CLOCK_THREAD_CPUTIME_ID`
+ *   on the executing worker, so time spent blocked or preempted is not charged.
+ * - A task's cost is only known once it finishes, but several workers may
+ *   dispatch from one tenant meanwhile. Dispatch therefore charges the tenant's
+ *   moving-average task cost (one quantum until a task has finished), and
+ *   `finish` replaces the estimate with the measured CPU time. Overdrawn credit
+ *   is carried into later turns as debt.
+ *
+ * @author dssregi
+ * @version 1.0
+ * @date 2025-11-14
+ */
+
+/**
+ * @brief What happens to a submission that would exceed a tenant's in-flight cap.
+ */
+enum class OverQuota {
+    /**
+     * @brief The submission fails; `ThreadPool::submit` returns false.
+     */
+    reject,
+
+    /**
+     * @brief The submitter waits until one of the tenant's tasks finishes.
+     */
+    delay
+};
+
+/**
+ * @brief Configuration of a tenant.
+ */
+struct TenantOptions {
+    /**
+     * @brief Name shown in statistics.
+     */
+    std::string name;
+
+    /**
+     * @brief Relative share: CPU-time quanta credited per DRR turn.
+     */
+    unsigned weight = 1;
+
+    /**
+     * @brief Maximum number of submitted but unfinished tasks.
+     */
+    size_t max_in_flight = std::numeric_limits<size_t>::max();
+
+    /**
+     * @brief Policy applied when a submission would exceed `max_in_flight`.
+     */
+    OverQuota policy = OverQuota::delay;
+};
+
+/**
+ * @brief Snapshot of one tenant's accounting.
+ */
+struct TenantStats {
+    std::string name;
+    unsigned weight = 1;
+    uint64_t submitted = 0;     ///< Accepted submissions.
+    uint64_t completed = 0;     ///< Finished tasks.
+    uint64_t rejected = 0;      ///< Submissions refused over quota.
+    uint64_t delayed = 0;       ///< Submissions that had to wait for quota.
+    uint64_t cpu_ns = 0;        ///< Thread CPU time consumed by finished tasks.
+};
+
+/**
+ * @brief Print one line per tenant.
+ */
+inline std::ostream& operator <<(std::ostream& os, const std::vector<TenantStats>& tenants) {
+    os << "Tenant accounting (weighted DRR, CPU time from CLOCK_THREAD_CPUTIME_ID):\n";
+    for (const TenantStats& t : tenants) {
+        os << "  " << std::left << std::setw(16) << t.name << std::right
+           << " weight=" << t.weight
+           << " submitted=" << t.submitted
+           << " completed=" << t.completed
+           << " rejected=" << t.rejected
+           << " delayed=" << t.delayed
+           << " cpu=" << std::fixed << std::setprecision(2) << t.cpu_ns / 1e6 << " ms"
+           << std::defaultfloat << "\n";
+    }
+    return os;
+}
+
+/**
+ * @brief CPU time consumed so far by the calling thread, in nanoseconds.
+ */
+inline uint64_t thread_cpu_ns() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+/**
+ * @brief A subsystem sharing the pool; obtained from `ThreadPool::add_tenant`.
+ *
+ * @thread_safety Counters are atomics; the queue and DRR state are protected by
+ *                the owning `TenantScheduler`'s mutex.
+ */
+template <class Task>
+class BasicTenant {
+private:
+    template <class> friend class TenantScheduler;
+
+    /**
+     * @brief Configuration fixed at registration.
+     */
+    const TenantOptions options_;
+
+    /**
+     * @brief Tasks waiting to be dispatched, in submission order.
+     */
+    std::deque<Task> queue_;
+
+    /**
+     * @brief CPU-time credit left in the tenant's current DRR turn, in ns;
+     *        negative while the tenant pays back overdrawn turns.
+     */
+    int64_t deficit_ = 0;
+
+    /**
+     * @brief Moving average of the tenant's task CPU time in ns, or 0 before
+     *        the first task finishes.
+     */
+    int64_t mean_cost_ns_ = 0;
+
+    /**
+     * @brief Whether the tenant is in the scheduler's round-robin list.
+     */
+    bool active_ = false;
+
+    std::atomic<size_t> in_flight_{0};
+    std::atomic<int> waiters_{0};
+    std::atomic<uint64_t> submitted_{0};
+    std::atomic<uint64_t> completed_{0};
+    std::atomic<uint64_t> rejected_{0};
+    std::atomic<uint64_t> delayed_{0};
+    std::atomic<uint64_t> cpu_ns_{0};
+
+public:
+    explicit BasicTenant(TenantOptions options) : options_(std::move(options)) {}
+
+    BasicTenant(const BasicTenant&) = delete;
+    BasicTenant& operator =(const BasicTenant&) = delete;
+
+    /**
+     * @brief Tenant name.
+     */
+    const std::string& name() const {
+        return options_.name;
+    }
+
+    /**
+     * @brief Accounting snapshot.
+     */
+    TenantStats stats() const {
+        TenantStats s;
+        s.name = options_.name;
+        s.weight = options_.weight;
+        s.submitted = submitted_.load(std::memory_order_relaxed);
+        s.completed = completed_.load(std::memory_order_relaxed);
+        s.rejected = rejected_.load(std::memory_order_relaxed);
+        s.delayed = delayed_.load(std::memory_order_relaxed);
+        s.cpu_ns = cpu_ns_.load(std::memory_order_relaxed);
+        return s;
+    }
+};
+
+/**
+ * @brief Per-tenant FIFOs dispatched by deficit round robin.
+ *
+ * @tparam Task Queued task type (the pool's `TaggedTask`).
+ *
+ * @thread_safety All methods are safe for concurrent use.
+ */
+template <class Task>
+class TenantScheduler {
+public:
+    using Tenant = BasicTenant<Task>;
+
+    /**
+     * @brief CPU time credited per unit of weight and DRR turn.
+     */
+    static constexpr int64_t QUANTUM_NS = 1000000;
+
+private:
+    /**
+     * @brief Mutex protecting tenant queues, DRR state and the tenant list.
+     */
+    std::mutex mut_;
+
+    /**
+     * @brief Signalled when a tenant's in-flight count drops (delay policy).
+     */
+    std::condition_variable room_;
+
+    /**
+     * @brief Registered tenants (stable addresses).
+     */
+    std::vector<std::unique_ptr<Tenant>> tenants_;
+
+    /**
+     * @brief Round-robin list of tenants with queued tasks; the front has the turn.
+     */
+    std::deque<Tenant*> active_;
+
+    /**
+     * @brief Total queued tenant tasks, readable without the lock.
+     *
+     * Sequentially consistent, so a submitter and a parking worker cannot both
+     * miss each other (see `ThreadPool::park`).
+     */
+    std::atomic<long> queued_{0};
+
+public:
+    TenantScheduler() = default;
+
+    TenantScheduler(const TenantScheduler&) = delete;
+    TenantScheduler& operator =(const TenantScheduler&) = delete;
+
+    /**
+     * @brief Register a tenant.
+     *
+     * @return Tenant handle, valid for the scheduler's lifetime.
+     */
+    Tenant& add(TenantOptions options) {
+        if (options.weight == 0) {
+            options.weight = 1;
+        }
+        if (options.max_in_flight == 0) {
+            options.max_in_flight = 1;
+        }
+        std::lock_guard<std::mutex> lock(mut_);
+        tenants_.push_back(std::make_unique<Tenant>(std::move(options)));
+        return *tenants_.back();
+    }
+
+    /**
+     * @brief Reserve an in-flight slot for @p tenant, applying its over-quota policy.
+     *
+     * @param tenant Submitting tenant.
+     * @param help Called repeatedly instead of blocking while a delayed submission
+     *        waits (pool workers pass a callback that runs other work), or nullptr
+     *        to block.
+     * @return true if a slot was reserved, false if the submission was rejected.
+     */
+    template <class Help>
+    bool admit(Tenant& tenant, Help* help) {
+        const size_t cap = tenant.options_.max_in_flight;
+        size_t current = tenant.in_flight_.load();
+        while (current < cap) {
+            if (tenant.in_flight_.compare_exchange_weak(current, current + 1)) {
+                return true;
+            }
+        }
+
+        if (tenant.options_.policy == OverQuota::reject) {
+            tenant.rejected_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        tenant.delayed_.fetch_add(1, std::memory_order_relaxed);
+        for (;;) {
+            current = tenant.in_flight_.load();
+            if (current < cap && tenant.in_flight_.compare_exchange_weak(current, current + 1)) {
+                return true;
+            }
+            if (help != nullptr) {
+                (*help)();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mut_);
+            tenant.waiters_.fetch_add(1);
+            room_.wait(lock, [&] { return tenant.in_flight_.load() < cap; });
+            tenant.waiters_.fetch_sub(1);
+        }
+    }
+
+    /**
+     * @brief Queue an admitted task on @p tenant's FIFO.
+     */
+    void push(Tenant& tenant, Task task) {
+        std::lock_guard<std::mutex> lock(mut_);
+        tenant.queue_.push_back(std::move(task));
+        tenant.submitted_.fetch_add(1, std::memory_order_relaxed);
+        if (!tenant.active_) {
+            // Unused credit is not banked across idle periods; debt is kept
+            tenant.active_ = true;
+            tenant.deficit_ = std::min<int64_t>(tenant.deficit_, 0);
+            active_.push_back(&tenant);
+        }
+        queued_.fetch_add(1);
+    }
+
+    /**
+     * @brief Dispatch the next task in deficit-round-robin order.
+     *
+     * The tenant at the front of the round starts a turn with `weight` quanta
+     * of credit added to its deficit; while the result is still not positive
+     * (debt from earlier turns) the turn passes to the next tenant.
+     *
+     * @param[out] task Where the task is placed.
+     * @param[out] owner Tenant the task belongs to; pass it to `finish`.
+     * @param[out] charged Estimated cost charged to @p owner; pass it to `finish`.
+     * @return true if a task was dispatched, false if no tenant has queued work.
+     */
+    bool try_pop(Task& task, Tenant*& owner, int64_t& charged) {
+        if (empty()) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mut_);
+        if (active_.empty()) {
+            return false;
+        }
+
+        Tenant* t = active_.front();
+        while (t->deficit_ <= 0) {
+            t->deficit_ += QUANTUM_NS * t->options_.weight; // start of this tenant's turn
+            if (t->deficit_ <= 0) {
+                active_.pop_front();
+                active_.push_back(t);
+                t = active_.front();
+            }
+        }
+
+        task = std::move(t->queue_.front());
+        t->queue_.pop_front();
+        charged = t->mean_cost_ns_ > 0 ? t->mean_cost_ns_ : QUANTUM_NS;
+        t->deficit_ -= charged;
+        queued_.fetch_sub(1);
+
+        if (t->queue_.empty()) {
+            t->active_ = false;
+            active_.pop_front();
+        } else if (t->deficit_ <= 0) {
+            active_.pop_front();
+            active_.push_back(t);
+        }
+
+        owner = t;
+        return true;
+    }
+
+    /**
+     * @brief Account a finished task, settle its DRR charge and release its
+     *        in-flight slot.
+     *
+     * @param tenant Tenant returned by `try_pop`.
+     * @param cpu_ns Thread CPU time the task consumed.
+     * @param charged Estimate returned by `try_pop`; replaced by @p cpu_ns.
+     */
+    void finish(Tenant& tenant, uint64_t cpu_ns, int64_t charged) {
+        tenant.cpu_ns_.fetch_add(cpu_ns, std::memory_order_relaxed);
+        tenant.completed_.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(mut_);
+            const int64_t cost = static_cast<int64_t>(cpu_ns);
+            tenant.deficit_ -= cost - charged;
+            tenant.mean_cost_ns_ = tenant.mean_cost_ns_ > 0 ? tenant.mean_cost_ns_ + (cost - tenant.mean_cost_ns_) / 8
+                                                            : std::max<int64_t>(cost, 1);
+        }
+        tenant.in_flight_.fetch_sub(1);
+        if (tenant.waiters_.load() > 0) {
+            std::lock_guard<std::mutex> lock(mut_);
+            room_.notify_all();
+        }
+    }
+
+    /**
+     * @brief Lock-free check for queued tenant work (sequentially consistent).
+     */
+    bool empty() const {
+        return queued_.load() == 0;
+    }
+
+    /**
+     * @brief Accounting snapshot of every tenant, in registration order.
+     */
+    std::vector<TenantStats> stats() {
+        std::lock_guard<std::mutex> lock(mut_);
+        std::vector<TenantStats> all;
+        for (const auto& t : tenants_) {
+            all.push_back(t->stats());
+        }
+        return all;
+    }
+};
+
+#endif // __TENANT_SCHEDULER_HPP__
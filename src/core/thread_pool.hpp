@@ -10,8 +10,30 @@
 #include <stop_token> 
 #include <algorithm> 
 #include <iostream>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <coroutine>
+#include <utility>
+#include <future>
+#include <string>
 
 #include "thread_safe_deque.hpp"
+#include "timer_wheel.hpp"
+#include "task_profiler.hpp"
+#include "perf_counters.hpp"
+#include "intrusive_task.hpp"
+#include "deadline_queue.hpp"
+#include "tenant_scheduler.hpp"
+#include "spin_barrier.hpp"
+#include "io_reactor.hpp"
+#include "pool_policies.hpp"
+#include "sdt_probes.hpp"
+#include "pool_stats.hpp"
+#include "task_watchdog.hpp"
+#include "worker_options.hpp"
+
+#include <sys/prctl.h>
 
 /**
  * @file thread_pool.hpp
@@ -29,6 +51,45 @@
  *   from peers (FIFO) to improve cache locality and work distribution.
  * - Graceful shutdown is triggered when the destructor is called, with all
  *   pending tasks executed before thread join.
+ * - Delayed and periodic tasks are kept in a hierarchical timer wheel that idle
+ *   workers service; no dedicated timer thread is used.
+ * - Tasks may carry a `TaskTag`; with timing enabled, per-tag duration histograms
+ *   feed `grain_report()`, which flags task classes too fine for the scheduler.
+ *   Hardware counters (cycles, instructions, cache and TLB misses) can likewise
+ *   be summed per tag into a `counter_report()`.
+ * - Every worker counts its tasks, steals and parks; `publish_stats` exports
+ *   them with queue depths to shared memory for external monitors (`wsp-top`).
+ * - An optional watchdog (`enable_watchdog`) reports tasks running longer than
+ *   a threshold with a stack sample of their worker and counts them.
+ * - Besides tasks, each worker owns a deque of suspended coroutine continuations
+ *   used by the work-first spawn mode (`work_first.hpp`); idle workers steal those
+ *   as well.
+ * - Objects deriving from `IntrusiveTask` can be submitted by reference: they are
+ *   linked into a second, allocation-free per-worker deque and never copied.
+ * - Tasks submitted with an absolute deadline form an optional EDF scheduling
+ *   class: workers run them before ordinary tasks, earliest deadline first, and
+ *   thieves favour the victim with the most urgent one. Misses are counted.
+ * - Subsystems sharing the pool can register as tenants: their tasks are queued
+ *   per tenant, dispatched by deficit round robin over the thread CPU time
+ *   they consume, weighted per tenant and capped in flight (`tenant_scheduler.hpp`).
+ * - `run_spmd` runs one function instance on every worker at once, with a
+ *   spinning-then-parking barrier for lock-step phases.
+ * - Asynchronous file reads and writes (`read_async`, `write_async`) go to
+ *   per-worker io_uring rings (or blocking-I/O threads where io_uring is
+ *   unavailable); idle workers reap completions and run their callbacks, and
+ *   a completion signal unparks a parked worker to reap it.
+ * - The pool is a class template over three strategies (`pool_policies.hpp`):
+ *   the per-worker queue, what an idle worker does before parking, and how
+ *   thieves pick victims. `ThreadPool` is the general-purpose combination;
+ *   `ThroughputThreadPool`, `LowLatencyThreadPool`, `LowPowerThreadPool` and
+ *   the never-parking `PollingThreadPool` are tuned variants.
+ * - `WorkerOptions` given to the constructor pin workers to CPUs and set their
+ *   scheduling class (e.g. `SCHED_FIFO` for latency, `SCHED_BATCH`/`SCHED_IDLE`
+ *   and a nice value for background work); `submit_latency()` measures the
+ *   resulting submit-to-start latency.
+ * - USDT static probes (`sdt_probes.hpp`, provider `wsp`) mark submissions,
+ *   own-queue pops, steal attempts, parking and task execution; they cost a
+ *   `nop` each until a tracer such as bpftrace attaches to the running binary.
  *
  * @author dssregi
  * @version 1.0
@@ -42,12 +103,67 @@
  */
 using TaskFunc = std::function<void()>;
 
+/**
+ * @brief Unit of work held in the pool's queues: a task and the tag it was submitted with.
+ *
+ * An empty `func` is a wake-up nudge and is skipped by the workers.
+ */
+struct TaggedTask {
+    /**
+     * @brief The callable to run.
+     */
+    TaskFunc func;
+
+    /**
+     * @brief Call-site tag used for profiling, or nullptr for untagged tasks.
+     */
+    const TaskTag* tag = nullptr;
+
+    /**
+     * @brief Addressed to the queue's owner: thieves leave it alone.
+     *
+     * Set on the wake-ups a waker pushes into a parked worker's queue; if a peer
+     * could steal one, the parked worker it was meant for would keep sleeping.
+     */
+    bool pinned = false;
+
+    TaggedTask() = default;
+
+    /**
+     * @brief Wrap a task, optionally attributing it to a tag.
+     */
+    TaggedTask(TaskFunc f, const TaskTag* t = nullptr) : func(std::move(f)), tag(t) {}
+};
+
 /**
  * @brief Queue type alias for thread-safe work-stealing deques.
  *
- * Each thread in the pool owns one such queue to hold its tasks.
+ * Each thread of a `ThreadPool` owns one such queue to hold its tasks.
+ */
+using Queue = ThreadSafeDeque<TaggedTask>;
+
+/**
+ * @brief Queue type alias for per-worker deques of stealable coroutine continuations.
+ *
+ * Used by the work-first (continuation-stealing) spawn mode: the owner pushes the
+ * parent's continuation before running a spawned child, thieves steal the oldest.
+ */
+using ContinuationQueue = ThreadSafeDeque<std::coroutine_handle<>>;
+
+/**
+ * @brief Handle of a subsystem sharing the pool, see `ThreadPool::add_tenant`.
+ */
+using Tenant = BasicTenant<TaggedTask>;
+
+/**
+ * @brief Distribution of submit-to-start latencies, see `ThreadPool::submit_latency`.
  */
-using Queue = ThreadSafeDeque<TaskFunc>;
+struct SubmitLatency {
+    double mean_ns = 0.0;   ///< Mean latency.
+    double p50_ns = 0.0;    ///< Median latency.
+    double p99_ns = 0.0;    ///< 99th percentile.
+    double max_ns = 0.0;    ///< Worst sample.
+};
 
 /**
  * @brief Work-stealing thread pool for parallel task execution.
@@ -61,12 +177,26 @@ using Queue = ThreadSafeDeque<TaskFunc>;
  * - `std::jthread` for automatic thread management and joining.
  * - `std::stop_token` for cooperative cancellation.
  *
+ * @tparam QueuePolicy Per-worker task queue, e.g. `MutexDequeQueue` or `LockFreeQueue`.
+ * @tparam IdlePolicy Spin, park, timer-slack and I/O-polling behaviour of idle
+ *         workers, e.g. `ParkWhenIdle`, `SpinThenPark<>`, `LowPowerIdle` or `BusyPoll`.
+ * @tparam VictimPolicy Per-worker steal victim selector, e.g. `RandomVictim` or
+ *         `RoundRobinVictim`.
+ *
+ * Tasks are always `TaggedTask`s: wake-ups rely on its `pinned` flag.
+ *
  * @thread_safety Thread pool operations are safe for concurrent task submission.
- *                Shutdown is coordinated via `stop_source_` and condition variables
- *                in the underlying `ThreadSafeDeque`.
+ *                Shutdown is coordinated via `stop_source_` and the closing of
+ *                every worker queue.
  */
-class ThreadPool {
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+class BasicThreadPool {
 private:
+    /**
+     * @brief Per-worker task queue type selected by the queue policy.
+     */
+    using TaskQueue = typename QueuePolicy::template type<TaggedTask>;
+
     /**
      * @brief Stop source for signalling worker threads to exit via stop tokens.
      */
@@ -84,23 +214,150 @@ private:
      *
      * Tasks are submitted to random queues and stolen across queues for load balancing.
      */
-    std::unique_ptr<Queue[]> work_queues;
+    std::unique_ptr<TaskQueue[]> work_queues;
+
+    /**
+     * @brief Per-worker deques of parent continuations published by work-first spawns.
+     *
+     * Unbounded, since a continuation is pushed per level of spawn recursion and
+     * the owner must never block on its own deque.
+     */
+    std::vector<std::unique_ptr<ContinuationQueue>> continuations_;
+
+    /**
+     * @brief Per-worker deques of intrusive tasks submitted by reference.
+     */
+    std::unique_ptr<IntrusiveTaskDeque[]> intrusive_queues_;
+
+    /**
+     * @brief Per-worker earliest-deadline-first queues of the deadline scheduling class.
+     */
+    std::unique_ptr<DeadlineQueue<TaggedTask>[]> deadline_queues_;
+
+    /**
+     * @brief Per-worker deadline hit/miss counters.
+     */
+    std::unique_ptr<DeadlineCounters[]> deadline_counters_;
+
+    /**
+     * @brief Per-tenant FIFOs shared by all workers, dispatched by weighted DRR.
+     */
+    TenantScheduler<TaggedTask> tenants_;
+
+    /**
+     * @brief Asynchronous I/O rings: one per worker plus one for outside threads.
+     */
+    std::unique_ptr<IoReactor> io_;
+
+    /**
+     * @brief Per-worker flag set while the worker is blocked on its own queue.
+     *
+     * A waker claims a parked worker by exchanging its flag to false, so the same
+     * worker is never woken twice for one wake-up.
+     */
+    std::unique_ptr<std::atomic<bool>[]> parked_;
+
+    /**
+     * @brief Number of workers currently parked; lets wakers skip the scan when zero.
+     */
+    std::atomic<int> parked_count_{0};
+
+    /**
+     * @brief Held for the whole of one `run_spmd` call.
+     *
+     * Instances of two calls must never interleave: a worker waiting at one
+     * call's barrier cannot run its instance of the other.
+     */
+    std::mutex spmd_mut_;
+
+    /**
+     * @brief Pool owning the calling thread, or nullptr if it is not a worker.
+     */
+    inline static thread_local BasicThreadPool* current_pool_ = nullptr;
 
     /**
-     * @brief Mersenne Twister RNG for random queue selection during submission and stealing.
+     * @brief Index of the calling worker within `current_pool_`, or -1.
      */
-    std::mt19937 mt;
+    inline static thread_local int current_index_ = -1;
 
     /**
-     * @brief Mutex protecting the RNG to ensure thread-safe random generation.
+     * @brief Continuation the running coroutine asked to transfer control to.
+     *
+     * Consumed by `run_continuation`, which resumes coroutines in a loop instead
+     * of relying on symmetric-transfer tail calls (not guaranteed at -O0 or under
+     * sanitizers), so stack depth stays bounded.
      */
-    std::mutex rand_mut;
+    inline static thread_local std::coroutine_handle<> next_continuation_;
 
     /**
      * @brief Number of worker threads in this pool.
      */
     int thread_count;
 
+    /**
+     * @brief Timer wheel holding tasks submitted via `submit_after` / `submit_every`.
+     */
+    TimerWheel<TaskFunc> timers_;
+
+    /**
+     * @brief Index of the worker currently parked with a timeout bounded by the
+     *        next timer expiry, or -1 if no worker is keeping time.
+     *
+     * Only one parked worker waits on the timer deadline; the others block
+     * indefinitely, so an expiry wakes exactly one thread.
+     */
+    std::atomic<int> timer_keeper_{-1};
+
+    /**
+     * @brief Per-worker, per-tag task duration histograms (timing off by default).
+     */
+    std::unique_ptr<TaskProfiler> profiler_;
+
+    /**
+     * @brief Per-worker counter groups and per-tag counter totals (counting off by default).
+     */
+    std::unique_ptr<TaskCounterProfiler> counters_;
+
+    /**
+     * @brief Per-worker task, steal and park counters (always on).
+     */
+    std::unique_ptr<WorkerCounters[]> worker_stats_;
+
+    /**
+     * @brief Mutex serializing creation of and writes to `stats_segment_`.
+     */
+    std::mutex stats_mut_;
+
+    /**
+     * @brief Shared-memory segment the counters are published to, once requested.
+     */
+    std::unique_ptr<StatsSegment> stats_segment_;
+
+    /**
+     * @brief Periodic timer refreshing `stats_segment_`, or 0 while not publishing.
+     */
+    TimerId stats_timer_ = 0;
+
+    /**
+     * @brief Per-worker current-task tracking and the stuck-task monitor (off by default).
+     */
+    std::unique_ptr<TaskWatchdog> watchdog_;
+
+    /**
+     * @brief CPU placement and scheduling class the workers apply at startup.
+     */
+    WorkerOptions options_;
+
+    /**
+     * @brief errno of the first worker option that could not be applied, or 0.
+     */
+    std::atomic<int> options_error_{0};
+
+    /**
+     * @brief Workers that have not applied `options_` yet; the constructor waits for 0.
+     */
+    std::atomic<int> options_pending_{0};
+
     /**
      * @brief Worker thread entry point.
      *
@@ -108,16 +365,194 @@ private:
      * @param idx Zero-based index of this worker thread.
      *
      * @details
-     * Executes the work-stealing loop:
-     *   1. Try LIFO pop from own queue (cache-friendly).
-     *   2. Try FIFO steal from a random peer queue.
-     *   3. Block on own queue until task available or close() called.
+     * Repeats `run_available_work` sweeps; when one finds nothing, sweeps up to
+     * `IdlePolicy::SPIN_SWEEPS` more times, then blocks on its own queue until a
+     * task is available or close() is called. The timer keeper bounds this wait
+     * by the next timer expiry; I/O completions wake a parked worker through the
+     * reactor.
      */
     void worker(std::stop_token token, int idx);
 
+    /**
+     * @brief One sweep of worker @p idx over every source of work; runs the first task found.
+     *
+     * @param idx Zero-based index of the sweeping worker.
+     * @param task Scratch slot for popped tasks.
+     * @param victims The worker's victim selector.
+     * @return true if something was run (or timers/I/O completions were released).
+     *
+     * @details
+     *   1. Run the most urgent task of own deadline queue, if any.
+     *   2. Try LIFO pop from own queues (cache-friendly).
+     *   3. Dispatch the next tenant task in CPU-time deficit-round-robin order.
+     *   4. Steal the most urgent deadline task of two sampled peers, then try
+     *      stealing from the victim policy's next peer.
+     *   5. Service expired timers, submitting their tasks.
+     *   6. Reap I/O completions, own ring first.
+     */
+    bool run_available_work(int idx, TaggedTask& task, VictimPolicy& victims);
+
+    /**
+     * @brief Block worker @p idx on its own queue, bounded by the next timer expiry
+     *        if this worker becomes the timer keeper.
+     *
+     * @param idx Zero-based index of the parking worker.
+     * @param[out] task Where a popped task is placed.
+     * @return true if a task was popped, false on timeout or if the queue was closed.
+     */
+    bool park(int idx, TaggedTask& task);
+
+    /**
+     * @brief Run a dequeued task on worker @p idx, timing it if profiling is enabled.
+     *
+     * @param idx Zero-based index of the executing worker.
+     * @param task Task to run; empty nudge tasks are skipped.
+     */
+    void execute(int idx, TaggedTask& task);
+
+    /**
+     * @brief Run a dequeued intrusive task on worker @p idx, timing it if profiling is enabled.
+     *
+     * @param idx Zero-based index of the executing worker.
+     * @param task Task to run; already unlinked from its deque.
+     */
+    void execute(int idx, IntrusiveTask* task);
+
+    /**
+     * @brief Invoke @p func, recording its duration under @p tag when profiling is enabled.
+     */
+    template <class F>
+    void run_timed(int idx, const TaskTag* tag, F&& func);
+
+    /**
+     * @brief Pop the earliest-deadline task of worker @p victim and run it on worker
+     *        @p idx, recording whether it met its deadline.
+     *
+     * @param idx Zero-based index of the executing worker.
+     * @param victim Index of the worker whose deadline queue is popped (may be @p idx).
+     * @return true if a task was run.
+     */
+    bool run_deadline_task(int idx, int victim);
+
+    /**
+     * @brief Pick, among two randomly sampled peers, the one whose deadline queue
+     *        holds the earlier deadline.
+     *
+     * @return Index of that peer, or -1 if neither has deadline work.
+     */
+    int most_urgent_victim();
+
+    /**
+     * @brief Dispatch the next tenant task and run it on worker @p idx, charging its
+     *        thread CPU time to the tenant.
+     *
+     * @return true if a task was run.
+     */
+    bool run_tenant_task(int idx);
+
+    /**
+     * @brief Wake one parked worker, if any, to pick up shared (tenant) work.
+     *
+     * @return true if a parked worker was claimed and nudged.
+     */
+    bool wake_idle_worker();
+
+    /**
+     * @brief Run one deadline or intrusive task queued on worker @p victim.
+     *
+     * @return true if a task was run.
+     */
+    bool steal_direct_work(int idx, int victim);
+
+    /**
+     * @brief Make sure work queued directly on worker @p target (outside its task
+     *        queue: an intrusive or deadline task) gets run promptly: wake @p target
+     *        if it is parked, otherwise ask a parked peer to steal it.
+     *
+     * @param target Index of the worker the task was queued on.
+     */
+    void wake_for_direct_work(int target);
+
+    /**
+     * @brief Push a pinned task (or an empty nudge) that only worker @p idx may run.
+     *
+     * Used to wake a specific parked worker, which a peer must not intercept.
+     *
+     * @param idx Index of the worker to wake.
+     * @param func Task for that worker to run on waking, or empty for a bare nudge.
+     */
+    void nudge(int idx, TaskFunc func = {});
+
+    /**
+     * @brief Copy the worker counters and queue depths into `stats_segment_`.
+     *
+     * Skips the snapshot if another one is being written.
+     */
+    void publish_stats_now();
+
+    /**
+     * @brief Start an asynchronous read or write on the caller's ring.
+     *
+     * Busy workers reap the completion in their steal loop, and the reactor's
+     * completion signal wakes a parked worker to reap it too.
+     */
+    void submit_io(IoOp op, int fd, void* buffer, size_t length, uint64_t offset, IoCallback done);
+
+    /**
+     * @brief Sink of the reactor: link @p req, which runs its callback when
+     *        executed, into the reaping worker's own intrusive deque when possible.
+     */
+    void complete_io(IoRequest* req);
+
+    /**
+     * @brief Advance the timer wheel; run the first expired task on worker @p idx
+     *        and submit the others.
+     *
+     * @param idx Zero-based index of the (otherwise idle) servicing worker.
+     * @return true if at least one timer task was released.
+     */
+    bool service_timers(int idx);
+
+    /**
+     * @brief Steal the oldest continuation from worker @p victim and resume it.
+     *
+     * @param victim Index of the worker whose continuation deque is robbed.
+     * @return true if a continuation was stolen and resumed.
+     */
+    bool steal_continuation(int victim);
+
+    /**
+     * @brief Whether any worker other than @p idx has a stealable continuation queued.
+     *
+     * A worker's own continuations are only ever taken by peers, so they do not
+     * keep it from parking.
+     */
+    bool peer_continuations_queued(int idx);
+
+    /**
+     * @brief Wake one parked worker and have it steal a continuation from @p victim.
+     *
+     * @param victim Index of the worker that just published a continuation.
+     */
+    void wake_thief(int victim);
+
+    /**
+     * @brief Arm a timer and, if it became the earliest, wake a worker to re-evaluate
+     *        its park timeout.
+     *
+     * @param delay Time until the first expiry.
+     * @param period Re-arm interval, or zero for a one-shot timer.
+     * @param func Task submitted on every expiry.
+     * @return Identifier of the new timer.
+     */
+    TimerId arm_timer(TimerWheel<TaskFunc>::Clock::duration delay,
+                   TimerWheel<TaskFunc>::Clock::duration period, TaskFunc func);
+
     /**
      * @brief Generate a random queue index uniformly in [0, thread_count).
      *
+     * Uses a per-thread generator, so concurrent submitters never contend.
+     *
      * @return Random queue index.
      */
     int get_random();
@@ -131,29 +566,32 @@ private:
 
 public:
     /**
-     * @brief Construct a ThreadPool with worker threads.
+     * @brief Construct a pool with worker threads.
      *
-     * Initializes worker threads based on hardware concurrency (capped at 4 for demo).
-     * Seeds the RNG and creates work queues for each thread.
+     * Initializes worker threads based on hardware concurrency (or
+     * @p options) and creates work queues for each thread.
+     *
+     * @param options Worker count, CPU pinning and scheduling class; each worker
+     *        applies them to itself as it starts (see `worker_options_error`).
      */
-    ThreadPool();
+    explicit BasicThreadPool(WorkerOptions options = {});
 
     /**
-     * @brief Destroy the ThreadPool and wait for all workers to finish.
+     * @brief Destroy the pool and wait for all workers to finish.
      *
      * Requests stop via `stop_source_`, closes all queues, and joins all jthreads.
      */
-    ~ThreadPool();
+    ~BasicThreadPool();
 
     /**
      * @brief Disable copy construction.
      */
-    ThreadPool(const ThreadPool&) = delete;
+    BasicThreadPool(const BasicThreadPool&) = delete;
 
     /**
      * @brief Disable copy assignment.
      */
-    ThreadPool& operator =(const ThreadPool&) = delete;
+    BasicThreadPool& operator =(const BasicThreadPool&) = delete;
 
     /**
      * @brief Submit a task to the thread pool for execution.
@@ -164,101 +602,1484 @@ public:
      * @param func Callable task to execute (must be convertible to `TaskFunc`).
      */
     void submit(TaskFunc func);
-};
 
-/**
- * @details
- * @name Inline Implementation of ThreadPool methods
- * @{
- */
+    /**
+     * @brief Submit a task attributed to a call-site tag.
+     *
+     * Identical to `submit(func)`, except that with task timing enabled the
+     * task's duration is recorded under @p tag.
+     *
+     * @param func Callable task to execute.
+     * @param tag Tag with static storage duration identifying the call site.
+     */
+    void submit(TaskFunc func, const TaskTag& tag);
 
-/**
- * @brief Constructor implementation: initialize threads and queues.
- */
-inline ThreadPool::ThreadPool() {
-    thread_count = std::max(1, (int)std::thread::hardware_concurrency());
-    std::cout << "ThreadPool starting with " << thread_count << " worker threads." << std::endl;
+    /**
+     * @brief Submit an intrusive task by reference, without copying or allocating.
+     *
+     * The task is linked into a randomly selected worker's intrusive deque. The
+     * pool never owns it: the caller keeps it alive until its `execute()` starts,
+     * and must not resubmit it before then.
+     *
+     * @param task Task to execute.
+     */
+    void submit(IntrusiveTask& task);
+
+    /**
+     * @brief Submit an intrusive task attributed to a call-site tag.
+     *
+     * @param task Task to execute.
+     * @param tag Tag with static storage duration identifying the call site.
+     */
+    void submit(IntrusiveTask& task, const TaskTag& tag);
 
-    std::random_device rd;
-    mt.seed(rd());
+    /**
+     * @brief Submit a task of the deadline scheduling class.
+     *
+     * Deadline tasks run before ordinary tasks, earliest deadline first. The
+     * deadline is a target, not a guarantee: a task finishing late is counted
+     * as a miss in `deadline_stats()`.
+     *
+     * @param deadline Absolute time by which the task should have finished.
+     * @param func Callable task to execute.
+     */
+    void submit_with_deadline(DeadlineQueue<TaggedTask>::Clock::time_point deadline, TaskFunc func);
 
-    work_queues = std::make_unique<Queue[]>(thread_count);
+    /**
+     * @brief Submit a task of the deadline scheduling class attributed to a tag.
+     *
+     * @param deadline Absolute time by which the task should have finished.
+     * @param func Callable task to execute.
+     * @param tag Tag with static storage duration identifying the call site.
+     */
+    void submit_with_deadline(DeadlineQueue<TaggedTask>::Clock::time_point deadline, TaskFunc func,
+                              const TaskTag& tag);
 
-    for (int i = 0; i < thread_count; ++i) {
-        threads.emplace_back([this, i](std::stop_token token) {
-            this->worker(std::move(token), i);
-        });
+    /**
+     * @brief Submit a deadline-class task that should finish within @p budget from now.
+     *
+     * @param budget Relative deadline, e.g. 16ms for an interactive preview.
+     * @param func Callable task to execute.
+     */
+    template <class Rep, class Period>
+    void submit_within(std::chrono::duration<Rep, Period> budget, TaskFunc func) {
+        using Clock = DeadlineQueue<TaggedTask>::Clock;
+        submit_with_deadline(Clock::now() + std::chrono::ceil<Clock::duration>(budget), std::move(func));
     }
-}
 
-/**
- * @brief Destructor implementation: request stop and join all threads.
- */
-inline ThreadPool::~ThreadPool() {
-    stop_source_.request_stop(); 
-    stop_workers();
-    std::cout << "ThreadPool shutting down cleanly. All jthreads joined." << std::endl;
-}
+    /**
+     * @brief Summarize how many deadline-class tasks met or missed their deadline.
+     *
+     * @return Counts and lateness merged over all workers (racy snapshot).
+     */
+    DeadlineStats deadline_stats() const;
 
-/**
- * @brief Implementation of stop_workers: close all queues to signal exit.
- */
-inline void ThreadPool::stop_workers() {
-    for (int i = 0; i < thread_count; ++i) {
-        work_queues[i].close();
-    }
-}
+    /**
+     * @brief Register a subsystem that submits work to this pool.
+     *
+     * @param options Name, DRR weight, in-flight cap and over-quota policy.
+     * @return Tenant handle to pass to `submit(func, tenant)`, valid for the
+     *         pool's lifetime.
+     */
+    Tenant& add_tenant(TenantOptions options);
 
-/**
- * @brief Implementation of worker: main loop for work-stealing execution.
- */
-inline void ThreadPool::worker(std::stop_token token, int idx) {
-    TaskFunc task;
-    
-    while (!token.stop_requested()) { 
-        // 1. Primary: Try LIFO pop from own queue (optimal cache use)
-        if (work_queues[idx].try_pop(task)) {
-            task();
-            continue;
-        }
+    /**
+     * @brief Submit a task on behalf of a tenant.
+     *
+     * The task waits in the tenant's FIFO and is dispatched in deficit-round-robin
+     * order with other tenants' tasks, so tenants share CPU time by weight. If the tenant already has `max_in_flight`
+     * unfinished tasks, the submission is rejected or delayed according to the
+     * tenant's policy; a delayed submission made from a pool worker runs other
+     * tenant work while it waits instead of blocking.
+     *
+     * @param func Callable task to execute.
+     * @param tenant Tenant obtained from `add_tenant` on this pool.
+     * @return true if the task was accepted, false if it was rejected over quota.
+     */
+    bool submit(TaskFunc func, Tenant& tenant);
 
-        // 2. Stealing: Check a random queue
+    /**
+     * @brief Per-tenant submission, quota and CPU-time accounting.
+     *
+     * @return One entry per tenant, in registration order.
+     */
+    std::vector<TenantStats> tenant_stats();
+
+    /**
+     * @brief Run @p fn once on every worker concurrently (SPMD mode) and wait.
+     *
+     * Each worker calls `fn(worker_id, barrier)`; workers synchronize phases with
+     * `barrier.arrive_and_wait()`, which spins briefly and then parks. The
+     * instances are pinned tasks, so no worker can steal another's. If called
+     * from a worker of this pool, the caller runs its own instance inline, on
+     * its current stack.
+     *
+     * Concurrent calls are serialised: each waits until the previous one has
+     * finished, a worker caller running its own queued tasks meanwhile. An
+     * instance must not call `run_spmd` itself.
+     *
+     * @param fn Callable `void(int worker_id, SpinBarrier& barrier)`; must not throw.
+     *        Every instance must make the same number of barrier calls.
+     */
+    template <class F>
+    void run_spmd(F&& fn);
+
+    /**
+     * @brief Read from a file asynchronously and call @p done with the result.
+     *
+     * The request is queued on the calling worker's io_uring ring (outside threads
+     * share one ring); the worker goes on with other tasks, and whichever worker
+     * reaps the completion runs @p done as an ordinary task. @p buffer must stay
+     * valid until then.
+     *
+     * @param fd Open file descriptor.
+     * @param buffer Destination of the data.
+     * @param length Number of bytes to read (at most 4 GiB - 1).
+     * @param offset File offset to read from.
+     * @param done Called with the number of bytes read, or a negated errno value.
+     */
+    void read_async(int fd, void* buffer, size_t length, uint64_t offset, IoCallback done);
+
+    /**
+     * @brief Read from a file asynchronously, returning a future of the result.
+     *
+     * Waiting on the future from a pool worker blocks that worker; prefer the
+     * callback overload inside tasks.
+     *
+     * @return Future of the number of bytes read, or a negated errno value.
+     */
+    std::future<ssize_t> read_async(int fd, void* buffer, size_t length, uint64_t offset);
+
+    /**
+     * @brief Write to a file asynchronously and call @p done with the result.
+     *
+     * @param fd Open file descriptor.
+     * @param buffer Source of the data; must stay valid until @p done runs.
+     * @param length Number of bytes to write (at most 4 GiB - 1).
+     * @param offset File offset to write at.
+     * @param done Called with the number of bytes written, or a negated errno value.
+     */
+    void write_async(int fd, const void* buffer, size_t length, uint64_t offset, IoCallback done);
+
+    /**
+     * @brief Write to a file asynchronously, returning a future of the result.
+     *
+     * @return Future of the number of bytes written, or a negated errno value.
+     */
+    std::future<ssize_t> write_async(int fd, const void* buffer, size_t length, uint64_t offset);
+
+    /**
+     * @brief Whether asynchronous I/O uses io_uring (false: blocking-I/O threads).
+     */
+    bool io_uring_enabled() const {
+        return io_->uses_io_uring();
+    }
+
+    /**
+     * @brief Turn per-task timing on or off.
+     *
+     * While on, every executed task's duration is recorded into the executing
+     * worker's histogram for the task's tag (untagged tasks share one tag).
+     *
+     * @param enabled Whether to time tasks.
+     */
+    void enable_task_timing(bool enabled = true);
+
+    /**
+     * @brief Turn per-task hardware counting on or off.
+     *
+     * While on, each worker reads its perf_event_open counter group around every
+     * task and adds the differences to the task's tag. Where hardware counters
+     * are unavailable, tasks run uncounted and `counter_report()` says why.
+     *
+     * @param enabled Whether to count tasks.
+     */
+    void enable_task_counters(bool enabled = true);
+
+    /**
+     * @brief Per-tag hardware counter totals recorded while counting was on.
+     *
+     * @return Report with one entry per counted tag (racy snapshot).
+     */
+    CounterReport counter_report() const;
+
+    /**
+     * @brief Publish per-worker statistics to a POSIX shared-memory segment.
+     *
+     * Creates the segment @p name (e.g. "/wsp-demo", i.e. `/dev/shm/wsp-demo`)
+     * and refreshes it every @p interval from a periodic pool task until the
+     * pool is destroyed or `unpublish_stats` is called, either of which also
+     * removes the segment. Readers such as `wsp-top` attach without affecting
+     * the pool (see `pool_stats.hpp`). Calling it again while publishing has no
+     * effect.
+     *
+     * @param name Shared-memory object name, starting with '/'.
+     * @param interval Refresh period.
+     * @throws std::system_error if the segment cannot be created.
+     */
+    void publish_stats(const std::string& name,
+                       std::chrono::milliseconds interval = std::chrono::milliseconds(100));
+
+    /**
+     * @brief Stop publishing statistics and remove the shared-memory segment.
+     *
+     * Has no effect if `publish_stats` was not called.
+     */
+    void unpublish_stats();
+
+    /**
+     * @brief Report tasks that run longer than @p threshold while they are still running.
+     *
+     * A monitor thread checks every worker's current task several times per
+     * threshold. For each task over it, the worker's stack is sampled by
+     * signalling the worker (`SIGRTMIN + 4`), and @p handler receives the tag,
+     * run time and frames; by default the report goes to std::cerr. Every such
+     * task is also counted (`long_task_count`, and the published statistics).
+     * Calling it again replaces the threshold and handler.
+     *
+     * @param threshold Run time after which a task counts as stuck.
+     * @param handler Called from the monitor thread, once per stuck task.
+     */
+    void enable_watchdog(std::chrono::milliseconds threshold, StuckTaskHandler handler = {});
+
+    /**
+     * @brief Stop the watchdog started by `enable_watchdog`.
+     */
+    void disable_watchdog();
+
+    /**
+     * @brief Number of tasks that exceeded the watchdog threshold while it was enabled.
+     */
+    uint64_t long_task_count() const;
+
+    /**
+     * @brief Estimate the scheduling overhead of one task.
+     *
+     * Submits a burst of no-op tasks with a ConvolutionTask-sized capture and
+     * divides the time until all of them have run by their number, so the
+     * figure includes allocation, queue locking, wake-ups and dispatch. Must be
+     * called from outside the pool, ideally while it is otherwise idle.
+     *
+     * @return Estimated overhead in nanoseconds.
+     */
+    double scheduling_overhead_ns();
+
+    /**
+     * @brief Measure the time from `submit` to the start of the task.
+     *
+     * Submits @p samples no-op tasks one at a time, waiting @p gap before each
+     * so that workers go idle (and park, if their policy parks) in between; the
+     * figures therefore include any wake-up. Must be called from outside the
+     * pool, ideally while it is otherwise idle.
+     *
+     * @param samples Number of tasks to time.
+     * @param gap Idle time before each submission.
+     * @return Mean, median, 99th percentile and maximum latency.
+     */
+    SubmitLatency submit_latency(int samples = 200,
+                                 std::chrono::microseconds gap = std::chrono::microseconds(200));
+
+    /**
+     * @brief Analyse recorded task durations and recommend grain-size changes.
+     *
+     * Calibrates the overhead with `scheduling_overhead_ns()`, so it must be
+     * called from outside the pool.
+     *
+     * @param target_share Scheduling overhead share considered acceptable; tags
+     *        above it get a suggested coarsening factor.
+     * @return Report with one entry per tag observed while timing was enabled.
+     */
+    GrainReport grain_report(double target_share = 0.1);
+
+    /**
+     * @brief Submit a task to run once after a delay.
+     *
+     * The task is armed in the pool's timer wheel and submitted to a work queue
+     * by an idle worker once the delay has elapsed. Timers have millisecond
+     * resolution and never fire early.
+     *
+     * @param delay Minimum time to wait before the task becomes runnable.
+     * @param func Callable task to execute.
+     * @return Identifier with which the task can be cancelled before it fires.
+     */
+    template <class Rep, class Period>
+    TimerId submit_after(std::chrono::duration<Rep, Period> delay, TaskFunc func) {
+        return arm_timer(std::chrono::ceil<TimerWheel<TaskFunc>::Clock::duration>(delay),
+                  TimerWheel<TaskFunc>::Clock::duration::zero(), std::move(func));
+    }
+
+    /**
+     * @brief Submit a task to run repeatedly with a fixed period.
+     *
+     * The first run happens one period from now. Runs are scheduled at a fixed
+     * rate; periods missed while all workers were busy are skipped rather than
+     * run back-to-back. Periodic tasks stay armed until cancelled with
+     * `cancel_timer` or until the pool is destroyed.
+     *
+     * @param period Interval between runs (must be positive).
+     * @param func Callable task to execute; copied on every run.
+     * @return Identifier with which the task can be cancelled.
+     */
+    template <class Rep, class Period>
+    TimerId submit_every(std::chrono::duration<Rep, Period> period, TaskFunc func) {
+        auto interval = std::chrono::ceil<TimerWheel<TaskFunc>::Clock::duration>(period);
+        return arm_timer(interval, interval, std::move(func));
+    }
+
+    /**
+     * @brief Cancel a task submitted with `submit_after` or `submit_every`.
+     *
+     * A run whose timer expired just before the call may still be queued and
+     * execute; no run starts later than that.
+     *
+     * @param id Identifier returned at submission.
+     * @return true if the timer was still armed, false if it had already fired
+     *         (one-shot) or been cancelled.
+     */
+    bool cancel_timer(TimerId id) {
+        return timers_.cancel(id);
+    }
+
+    /**
+     * @brief Get the pool owning the calling thread.
+     *
+     * @return The pool whose worker is calling, or nullptr for non-worker threads.
+     */
+    static BasicThreadPool* current() {
+        return current_pool_;
+    }
+
+    /**
+     * @brief Get the index of the calling worker within its pool.
+     *
+     * @return Zero-based worker index, or -1 if the caller is not a pool worker.
+     */
+    static int current_worker_index() {
+        return current_index_;
+    }
+
+    /**
+     * @brief Get the number of worker threads.
+     *
+     * @return Worker count fixed at construction.
+     */
+    int size() const {
+        return thread_count;
+    }
+
+    /**
+     * @brief errno of the first `WorkerOptions` setting a worker failed to apply.
+     *
+     * @return 0 if every worker applied all of its options (settled once the
+     *         constructor has returned).
+     */
+    int worker_options_error() const {
+        return options_error_.load();
+    }
+
+    /**
+     * @brief Get the number of workers currently parked waiting for work.
+     *
+     * A racy snapshot, intended for scheduling heuristics such as deciding
+     * whether splitting off more parallel work would be picked up right away.
+     *
+     * @return Number of parked workers.
+     */
+    int idle_workers() const {
+        return parked_count_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Publish a suspended continuation on the calling worker's deque.
+     *
+     * Building block of the work-first spawn mode; must be called from a worker
+     * of this pool. If any worker is parked, one is woken to steal it.
+     *
+     * @param handle Continuation of the spawning coroutine.
+     */
+    void push_continuation(std::coroutine_handle<> handle);
+
+    /**
+     * @brief Take back a continuation previously published by the calling worker.
+     *
+     * Succeeds only if @p handle is still the newest entry of the calling worker's
+     * continuation deque, i.e. no thief stole it.
+     *
+     * @param handle Continuation to reclaim.
+     * @return true if the continuation was reclaimed and the caller should resume it.
+     */
+    bool try_reclaim_continuation(std::coroutine_handle<> handle);
+
+    /**
+     * @brief Ask the trampoline in `run_continuation` to resume @p handle next.
+     *
+     * Called from an `await_suspend` instead of returning the handle.
+     *
+     * @param handle Coroutine to resume once the current one has suspended.
+     */
+    static void transfer_to(std::coroutine_handle<> handle) {
+        next_continuation_ = handle;
+    }
+
+    /**
+     * @brief Resume a coroutine and every coroutine it transfers control to.
+     *
+     * @param handle First coroutine to resume.
+     */
+    static void run_continuation(std::coroutine_handle<> handle) {
+        while (handle) {
+            handle.resume();
+            handle = std::exchange(next_continuation_, {});
+        }
+    }
+};
+
+/**
+ * @brief General-purpose pool: bounded mutex deques, park when idle, random victims.
+ *
+ * Submitters block while the chosen queue is full, which throttles producers
+ * that outpace the workers.
+ */
+using ThreadPool = BasicThreadPool<MutexDequeQueue, ParkWhenIdle, RandomVictim>;
+
+/**
+ * @brief Throughput variant: lock-free queues with futex parking, random victims.
+ *
+ * Submission and stealing never take a lock; queues are unbounded, so there is
+ * no producer back-pressure.
+ */
+using ThroughputThreadPool = BasicThreadPool<LockFreeQueue, ParkWhenIdle, RandomVictim>;
+
+/**
+ * @brief Low-latency variant: lock-free queues, workers spin before parking and
+ *        probe peers round-robin.
+ *
+ * Bursty submitters find a worker still awake, at the cost of CPU time burnt
+ * after each burst.
+ */
+using LowLatencyThreadPool = BasicThreadPool<LockFreeQueue, SpinThenPark<>, RoundRobinVictim>;
+
+/**
+ * @brief Low-power variant: mutex deques, no spinning, and kernel timer slack
+ *        to batch wake-ups.
+ */
+using LowPowerThreadPool = BasicThreadPool<MutexDequeQueue, LowPowerIdle, RandomVictim>;
+
+/**
+ * @brief Polling variant: lock-free queues, workers never park, round-robin victims.
+ *
+ * Work starts within one sweep of being submitted, without any wake-up. Give
+ * it `WorkerOptions::cpus` naming isolated cores: each worker spins on its
+ * core at 100% until the pool is destroyed.
+ */
+using PollingThreadPool = BasicThreadPool<LockFreeQueue, BusyPoll, RoundRobinVictim>;
+
+/**
+ * @details
+ * @name Inline Implementation of BasicThreadPool methods
+ * @{
+ */
+
+/**
+ * @brief Constructor implementation: initialize threads and queues.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::BasicThreadPool(WorkerOptions options)
+    : options_(std::move(options)) {
+    thread_count = options_.threads > 0 ? options_.threads
+                 : !options_.cpus.empty() ? static_cast<int>(options_.cpus.size())
+                 : std::max(1, (int)std::thread::hardware_concurrency());
+    std::cout << "ThreadPool starting with " << thread_count << " worker threads." << std::endl;
+
+    work_queues = std::make_unique<TaskQueue[]>(thread_count);
+    intrusive_queues_ = std::make_unique<IntrusiveTaskDeque[]>(thread_count);
+    deadline_queues_ = std::make_unique<DeadlineQueue<TaggedTask>[]>(thread_count);
+    deadline_counters_ = std::make_unique<DeadlineCounters[]>(thread_count);
+    parked_ = std::make_unique<std::atomic<bool>[]>(thread_count);
+    profiler_ = std::make_unique<TaskProfiler>(thread_count);
+    counters_ = std::make_unique<TaskCounterProfiler>(thread_count);
+    worker_stats_ = std::make_unique<WorkerCounters[]>(thread_count);
+    watchdog_ = std::make_unique<TaskWatchdog>(thread_count);
+    io_ = std::make_unique<IoReactor>(thread_count + 1, [this](IoRequest* req) { complete_io(req); },
+                                      [this] { wake_idle_worker(); });
+    for (int i = 0; i < thread_count; ++i) {
+        continuations_.push_back(std::make_unique<ContinuationQueue>(std::numeric_limits<size_t>::max()));
+    }
+
+    options_pending_.store(thread_count);
+    for (int i = 0; i < thread_count; ++i) {
+        threads.emplace_back([this, i](std::stop_token token) {
+            this->worker(std::move(token), i);
+        });
+        watchdog_->set_thread(i, threads.back().native_handle());
+    }
+
+    // Wait until every worker has placed itself, so option errors are known
+    for (int pending = options_pending_.load(); pending != 0; pending = options_pending_.load()) {
+        options_pending_.wait(pending);
+    }
+}
+
+/**
+ * @brief Destructor implementation: request stop and join all threads.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::~BasicThreadPool() {
+    stop_source_.request_stop(); 
+    // The monitor must not signal workers that are exiting
+    watchdog_->stop();
+    stop_workers();
+    // Join before members such as the queues and the timer wheel are destroyed.
+    threads.clear();
+    // The reactor's threads wake workers through parked_, which is declared later
+    io_.reset();
+    std::cout << "ThreadPool shutting down cleanly. All jthreads joined." << std::endl;
+}
+
+/**
+ * @brief Implementation of stop_workers: close all queues to signal exit.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline void BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::stop_workers() {
+    for (int i = 0; i < thread_count; ++i) {
+        work_queues[i].close();
+        continuations_[i]->close();
+    }
+}
+
+/**
+ * @brief Implementation of worker: main loop for work-stealing execution.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline void BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::worker(std::stop_token token, int idx) {
+    TaggedTask task;
+    VictimPolicy victims(static_cast<uint32_t>(idx));
+    int idle_sweeps = 0;
+    current_pool_ = this;
+    current_index_ = idx;
+
+    if (int error = apply_worker_options(options_, idx); error != 0) {
+        int none = 0;
+        options_error_.compare_exchange_strong(none, error);
+    }
+    if (options_pending_.fetch_sub(1) == 1) {
+        options_pending_.notify_all();
+    }
+
+    if constexpr (IdlePolicy::TIMER_SLACK.count() > 0) {
+        // Let the kernel defer this thread's timed waits to batch its wake-ups
+        prctl(PR_SET_TIMERSLACK, static_cast<unsigned long>(IdlePolicy::TIMER_SLACK.count()), 0, 0, 0);
+    }
+    
+    while (!token.stop_requested()) { 
+        if (run_available_work(idx, task, victims)) {
+            idle_sweeps = 0;
+            continue;
+        }
+
+        // 7. Spin: low-latency policies sweep again before paying for a park
+        if (idle_sweeps < IdlePolicy::SPIN_SWEEPS) {
+            ++idle_sweeps;
+            cpu_relax();
+            continue;
+        }
+        idle_sweeps = 0;
+
+        // Polling policies never park: sweep again after a pause
+        if constexpr (!IdlePolicy::PARK) {
+            cpu_relax();
+            continue;
+        }
+        
+        // 8. Last Resort: Block efficiently on our own queue (LIFO pop)
+        // If park returns false, either the timer deadline passed or close() was called
+        // and the queue is empty; the loop condition tells the two apart.
+        if (!park(idx, task)) {
+            continue; 
+        }
+        
+        execute(idx, task);
+    }
+    std::cout << "Worker " << idx << " exited." << std::endl;
+}
+
+/**
+ * @brief Implementation of run_available_work: one sweep, own queues before peers'.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline bool BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::run_available_work(int idx, TaggedTask& task,
+                                                                                      VictimPolicy& victims) {
+    // 1. Urgent: deadline-class tasks come before ordinary work
+    if (run_deadline_task(idx, idx)) {
+        return true;
+    }
+
+    // 2. Primary: Try LIFO pop from own queue (optimal cache use)
+    if (work_queues[idx].try_pop(task)) {
+        WSP_PROBE1(pop, idx);
+        execute(idx, task);
+        return true;
+    }
+
+    if (IntrusiveTask* node = intrusive_queues_[idx].try_pop()) {
+        WSP_PROBE1(pop, idx);
+        execute(idx, node);
+        return true;
+    }
+
+    // 3. Shared: tenant FIFOs in CPU-time deficit-round-robin order
+    if (run_tenant_task(idx)) {
+        return true;
+    }
+
+    // 4. Stealing: the most urgent deadline task of two sampled peers first,
+    // then the victim policy's next queue
+    int urgent = most_urgent_victim();
+    if (urgent >= 0 && run_deadline_task(idx, urgent)) {
+        return true;
+    }
+
+    int i = victims.next(thread_count);
+
+    // Pinned wake-ups are left for the owner they were meant to wake
+    if (work_queues[i].try_steal_if(task, [](const TaggedTask& t) { return !t.pinned; })) { 
+        WSP_PROBE3(steal, idx, i, true);
+        WorkerCounters::add(worker_stats_[idx].steals);
+        execute(idx, task);
+        return true;
+    }
+
+    if (IntrusiveTask* node = intrusive_queues_[i].try_steal()) {
+        WSP_PROBE3(steal, idx, i, true);
+        WorkerCounters::add(worker_stats_[idx].steals);
+        execute(idx, node);
+        return true;
+    }
+    WSP_PROBE3(steal, idx, i, false);
+    WorkerCounters::add(worker_stats_[idx].failed_steals);
+
+    // ... and the continuations its work-first spawns left behind
+    if (i != idx && steal_continuation(i)) {
+        return true;
+    }
+
+    // 5. Idle: release any expired timers before going to sleep
+    if (service_timers(idx)) {
+        return true;
+    }
+
+    // 6. ... and any finished I/O, whose callbacks land on our own deque
+    return io_->poll(idx) > 0;
+}
+
+/**
+ * @brief Implementation of park: block on own queue, keeping time if nobody else is.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline bool BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::park(int idx, TaggedTask& task) {
+    WSP_PROBE1(park, idx);
+    parked_[idx].store(true);
+    parked_count_.fetch_add(1);
+
+    // Intrusive, deadline and tenant submissions, peers' work-first continuations
+    // and I/O completions do not go through the work queue, so re-check after
+    // publishing the parked flag: either we see the work here, or its submitter
+    // (or the reactor's wake callback) sees the flag and nudges us (both sides
+    // use sequentially consistent ops).
+    if (!intrusive_queues_[idx].empty() || !deadline_queues_[idx].empty() || !tenants_.empty() ||
+        io_->ready() || peer_continuations_queued(idx)) {
+        parked_[idx].store(false);
+        parked_count_.fetch_sub(1);
+        WSP_PROBE2(unpark, idx, false);
+        return false;
+    }
+
+    bool popped = false;
+    int expected = -1;
+    WorkerCounters& stats = worker_stats_[idx];
+    const uint64_t parked_at = monotonic_ns();
+    stats.park_started.store(parked_at, std::memory_order_relaxed);
+    auto next = timers_.next_expiry();
+    if (next && timer_keeper_.compare_exchange_strong(expected, idx)) {
+        popped = work_queues[idx].wait_and_pop_until(task, *next);
+        timer_keeper_.store(-1);
+    } else {
+        popped = work_queues[idx].wait_and_pop(task);
+    }
+
+    WorkerCounters::add(stats.parks);
+    WorkerCounters::add(stats.parked_ns, monotonic_ns() - parked_at);
+    stats.park_started.store(0, std::memory_order_relaxed);
+    parked_[idx].store(false);
+    parked_count_.fetch_sub(1);
+    WSP_PROBE2(unpark, idx, popped);
+    return popped;
+}
+
+/**
+ * @brief Implementation of execute: dispatch one task, timing it when profiling.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline void BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::execute(int idx, TaggedTask& task) {
+    if (!task.func) {
+        return;
+    }
+    run_timed(idx, task.tag, task.func);
+}
+
+/**
+ * @brief Implementation of intrusive execute: the node is already unlinked, so it
+ *        may be resubmitted or destroyed by its own `execute()`.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline void BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::execute(int idx, IntrusiveTask* task) {
+    const TaskTag* tag = task->tag_;
+    run_timed(idx, tag, [task] { task->execute(); });
+}
+
+/**
+ * @brief Implementation of run_timed: time and count the call only while profiling
+ *        or counting is on; the begin/end probes fire either way.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+template <class F>
+inline void BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::run_timed(int idx, const TaskTag* tag, F&& func) {
+    // Probe argument: the tag name, or null for untagged tasks
+    const char* tag_name = tag ? tag->name() : nullptr;
+    WorkerCounters::add(worker_stats_[idx].tasks);
+    const bool timed = profiler_->enabled();
+    const bool watched = watchdog_->enabled();
+    if (!timed && !counters_->enabled() && !watched) {
+        WSP_PROBE2(task_begin, idx, tag_name);
+        func();
+        WSP_PROBE2(task_end, idx, tag_name);
+        return;
+    }
+
+    // Counters are read inside the timed interval, so the durations include the reads
+    auto start = std::chrono::steady_clock::now();
+    PerfValues counted_from;
+    const bool counted = counters_->enabled() && counters_->begin(idx, counted_from);
+    if (watched) {
+        watchdog_->begin(idx, tag);
+    }
+    WSP_PROBE2(task_begin, idx, tag_name);
+    func();
+    WSP_PROBE2(task_end, idx, tag_name);
+    if (watched) {
+        watchdog_->end(idx);
+    }
+    if (counted) {
+        counters_->record(idx, tag ? *tag : TaskTag::untagged(), counted_from);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    if (timed) {
+        profiler_->record(idx, tag ? *tag : TaskTag::untagged(),
+                          static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+}
+
+/**
+ * @brief Implementation of service_timers: run one expired task here, submit the rest.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline bool BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::service_timers(int idx) {
+    if (timers_.empty()) {
+        return false;
+    }
+
+    std::vector<TaskFunc> due;
+    if (timers_.advance(due) == 0) {
+        return false;
+    }
+
+    // A random queue may belong to a worker in the middle of a long task, which
+    // would hold the expired task back; parked peers are woken to steal the
+    // extras, and this worker is idle, so it runs the first itself.
+    for (size_t t = 1; t < due.size(); ++t) {
+        submit(std::move(due[t]));
+        wake_idle_worker();
+    }
+    TaggedTask first(std::move(due.front()));
+    execute(idx, first);
+    return true;
+}
+
+/**
+ * @brief Implementation of arm_timer: insert into the wheel and nudge a parked worker.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline TimerId BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::arm_timer(TimerWheel<TaskFunc>::Clock::duration delay,
+                                  TimerWheel<TaskFunc>::Clock::duration period, TaskFunc func) {
+    TimerId id = 0;
+    if (!timers_.schedule(delay, period, std::move(func), &id)) {
+        return id;
+    }
+
+    // The new timer expires before the current keeper's timeout (or nobody keeps
+    // time yet). An empty task wakes the owner of the queue, which re-parks with
+    // the new deadline; workers skip empty tasks. Without a keeper, a parked
+    // worker becomes one; a busy worker only sees the timer after its task.
+    int keeper = timer_keeper_.load();
+    if (keeper >= 0) {
+        nudge(keeper);
+    } else if (!wake_idle_worker()) {
+        nudge(get_random());
+    }
+    return id;
+}
+
+/**
+ * @brief Implementation of submit_io: queue on the caller's ring; the reactor wakes
+ *        a reaper on completion.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline void BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::submit_io(IoOp op, int fd, void* buffer, size_t length, uint64_t offset,
+                                  IoCallback done) {
+    auto req = std::make_unique<IoRequest>();
+    req->op = op;
+    req->fd = fd;
+    req->buffer = buffer;
+    req->length = length;
+    req->offset = offset;
+    req->done = std::move(done);
+
+    const int ring = current_pool_ == this ? current_index_ : thread_count;
+    io_->submit(ring, std::move(req));
+}
+
+/**
+ * @brief Implementation of complete_io: queue a reaped request as an intrusive task.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline void BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::complete_io(IoRequest* req) {
+    static const TaskTag io_tag("I/O completion");
+    req->tag_ = &io_tag;
+
+    // Unbounded, so a worker reaping a burst of completions never blocks on its
+    // own queue; the reaper runs them next unless peers steal some first
+    if (current_pool_ == this) {
+        intrusive_queues_[current_index_].push(req);
+    } else {
         int i = get_random();
-        
-        // Use try_steal (FIFO pop) from the random queue
-        if (work_queues[i].try_steal(task)) { 
-            task();
-            continue;
+        intrusive_queues_[i].push(req);
+        wake_for_direct_work(i);
+    }
+}
+
+/**
+ * @brief Implementation of steal_continuation: FIFO steal from a peer and resume.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline bool BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::steal_continuation(int victim) {
+    std::coroutine_handle<> handle;
+    if (!continuations_[victim]->try_steal(handle)) {
+        return false;
+    }
+    run_continuation(handle);
+    return true;
+}
+
+/**
+ * @brief Implementation of wake_thief: hand a parked worker a targeted steal request.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline void BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::wake_thief(int victim) {
+    if (parked_count_.load() == 0) {
+        return;
+    }
+
+    int start = get_random();
+    for (int k = 0; k < thread_count; ++k) {
+        int j = (start + k) % thread_count;
+        if (j != victim && parked_[j].exchange(false)) {
+            nudge(j, [this, victim] { steal_continuation(victim); });
+            return;
         }
-        
-        // 3. Last Resort: Block efficiently on our own queue (LIFO pop)
-        // If wait_and_pop returns false, it means close() was called and the queue is empty.
-        if (!work_queues[idx].wait_and_pop(task)) {
-            break; 
+    }
+}
+
+/**
+ * @brief Implementation of run_deadline_task: EDF pop, run, and score against the deadline.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline bool BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::run_deadline_task(int idx, int victim) {
+    TaggedTask task;
+    DeadlineQueue<TaggedTask>::Clock::time_point deadline;
+    if (!deadline_queues_[victim].try_pop(task, deadline)) {
+        return false;
+    }
+
+    execute(idx, task);
+
+    auto late = DeadlineQueue<TaggedTask>::Clock::now() - deadline;
+    deadline_counters_[idx].record(late.count() > 0
+        ? static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(late).count()) : 0);
+    return true;
+}
+
+/**
+ * @brief Implementation of most_urgent_victim: power-of-two-choices on head deadlines.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline int BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::most_urgent_victim() {
+    int a = get_random();
+    int b = get_random();
+    auto da = deadline_queues_[a].earliest();
+    auto db = deadline_queues_[b].earliest();
+    if (da == DeadlineQueue<TaggedTask>::Clock::time_point::max() &&
+        db == DeadlineQueue<TaggedTask>::Clock::time_point::max()) {
+        return -1;
+    }
+    return da <= db ? a : b;
+}
+
+/**
+ * @brief Implementation of run_tenant_task: DRR dispatch with CPU-time accounting.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline bool BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::run_tenant_task(int idx) {
+    TaggedTask task;
+    Tenant* tenant = nullptr;
+    int64_t charged = 0;
+    if (!tenants_.try_pop(task, tenant, charged)) {
+        return false;
+    }
+
+    uint64_t start = thread_cpu_ns();
+    execute(idx, task);
+    tenants_.finish(*tenant, thread_cpu_ns() - start, charged);
+    return true;
+}
+
+/**
+ * @brief Implementation of run_spmd: one call at a time, one pinned instance per worker.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+template <class F>
+inline void BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::run_spmd(F&& fn) {
+    // Shared with the instances, so the last one may still signal after the
+    // caller has observed completion and returned.
+    struct SpmdState {
+        SpinBarrier barrier;
+        std::atomic<int> remaining;
+        explicit SpmdState(int workers) : barrier(workers), remaining(workers) {}
+    };
+    auto state = std::make_shared<SpmdState>(thread_count);
+
+    auto instance = [state, &fn](int id) {
+        fn(id, state->barrier);
+        if (state->remaining.fetch_sub(1) == 1) {
+            state->remaining.notify_all();
         }
-        
-        if (task) {
-            task();
+    };
+
+    // One call at a time. A worker waiting for its turn keeps popping its own
+    // queue, where the running call has pinned the instance it must execute.
+    int self = current_pool_ == this ? current_index_ : -1;
+    std::unique_lock<std::mutex> turn(spmd_mut_, std::defer_lock);
+    if (self >= 0) {
+        TaggedTask task;
+        while (!turn.try_lock()) {
+            if (work_queues[self].try_pop(task)) {
+                execute(self, task);
+            } else {
+                std::this_thread::yield();
+            }
         }
+    } else {
+        turn.lock();
     }
-    std::cout << "Worker " << idx << " exited." << std::endl;
+
+    for (int i = 0; i < thread_count; ++i) {
+        if (i != self) {
+            nudge(i, [instance, i] { instance(i); });
+        }
+    }
+    if (self >= 0) {
+        instance(self);
+    }
+
+    for (int left = state->remaining.load(); left != 0; left = state->remaining.load()) {
+        state->remaining.wait(left);
+    }
+}
+
+/**
+ * @brief Implementation of wake_idle_worker: claim any parked worker and nudge it.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline bool BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::wake_idle_worker() {
+    if (parked_count_.load() == 0) {
+        return false;
+    }
+
+    int start = get_random();
+    for (int k = 0; k < thread_count; ++k) {
+        int j = (start + k) % thread_count;
+        if (parked_[j].exchange(false)) {
+            nudge(j);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Implementation of steal_direct_work: deadline work first, then intrusive.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline bool BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::steal_direct_work(int idx, int victim) {
+    if (run_deadline_task(idx, victim)) {
+        return true;
+    }
+    if (IntrusiveTask* node = intrusive_queues_[victim].try_steal()) {
+        execute(idx, node);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Implementation of wake_for_direct_work: wake the target, or a parked thief.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline void BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::wake_for_direct_work(int target) {
+    if (parked_[target].exchange(false)) {
+        nudge(target);
+        return;
+    }
+    if (parked_count_.load() == 0) {
+        return;
+    }
+
+    int start = get_random();
+    for (int k = 0; k < thread_count; ++k) {
+        int j = (start + k) % thread_count;
+        if (j != target && parked_[j].exchange(false)) {
+            nudge(j, [this, target] { steal_direct_work(current_index_, target); });
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Implementation of nudge: push an owner-only task into worker @p idx's queue.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline void BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::nudge(int idx, TaskFunc func) {
+    TaggedTask task(std::move(func));
+    task.pinned = true;
+    work_queues[idx].push(std::move(task));
+}
+
+/**
+ * @brief Implementation of publish_stats: create the segment once, then refresh it periodically.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline void BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::publish_stats(const std::string& name,
+                                                                                 std::chrono::milliseconds interval) {
+    {
+        std::lock_guard<std::mutex> lock(stats_mut_);
+        if (stats_segment_) {
+            return;
+        }
+        stats_segment_ = std::make_unique<StatsSegment>(name, thread_count);
+        // Refreshes only try-lock, so arming under the lock cannot stall a worker
+        stats_timer_ = submit_every(interval, [this] { publish_stats_now(); });
+    }
+    publish_stats_now();
+}
+
+/**
+ * @brief Implementation of unpublish_stats: cancel the refresh, then remove the segment.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline void BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::unpublish_stats() {
+    std::lock_guard<std::mutex> lock(stats_mut_);
+    if (stats_timer_ != 0) {
+        cancel_timer(stats_timer_);
+        stats_timer_ = 0;
+    }
+    // A refresh still queued finds no segment and returns
+    stats_segment_.reset();
+}
+
+/**
+ * @brief Implementation of publish_stats_now: one seqlock-protected snapshot.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline void BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::publish_stats_now() {
+    std::unique_lock<std::mutex> lock(stats_mut_, std::try_to_lock);
+    if (!lock.owns_lock() || !stats_segment_) {
+        return;
+    }
+
+    stats_segment_->publish([this](int w, WorkerStatsSnapshot& out) {
+        const WorkerCounters& in = worker_stats_[w];
+        out.tasks = in.tasks.load(std::memory_order_relaxed);
+        out.steals = in.steals.load(std::memory_order_relaxed);
+        out.failed_steals = in.failed_steals.load(std::memory_order_relaxed);
+        out.parks = in.parks.load(std::memory_order_relaxed);
+        // Include the park in progress, so a long-idle worker does not look busy
+        const uint64_t park_started = in.park_started.load(std::memory_order_relaxed);
+        out.parked_ns = in.parked_ns.load(std::memory_order_relaxed);
+        if (park_started != 0) {
+            out.parked_ns += monotonic_ns() - park_started;
+        }
+        out.queued = work_queues[w].size() + static_cast<uint64_t>(intrusive_queues_[w].size()) +
+                     deadline_queues_[w].size();
+        out.parked = parked_[w].load(std::memory_order_relaxed);
+        out.long_tasks = watchdog_->long_tasks(w);
+    });
+}
+
+/**
+ * @brief Implementation of enable_watchdog: (re)start the monitor thread.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline void BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::enable_watchdog(std::chrono::milliseconds threshold,
+                                                                                   StuckTaskHandler handler) {
+    watchdog_->start(threshold, std::move(handler));
+}
+
+/**
+ * @brief Implementation of disable_watchdog: stop the monitor thread.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline void BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::disable_watchdog() {
+    watchdog_->stop();
+}
+
+/**
+ * @brief Implementation of long_task_count: sum of the per-worker counters.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline uint64_t BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::long_task_count() const {
+    return watchdog_->long_task_count();
+}
+
+/**
+ * @brief Implementation of push_continuation: publish on the caller's deque.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline void BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::push_continuation(std::coroutine_handle<> handle) {
+    continuations_[current_index_]->push(handle);
+    // Order the push before reading the parked flags, as `park` orders its flag
+    // before re-checking the continuation deques
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    wake_thief(current_index_);
+}
+
+/**
+ * @brief Implementation of peer_continuations_queued: scan every other worker's deque.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline bool BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::peer_continuations_queued(int idx) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (int i = 0; i < thread_count; ++i) {
+        if (i != idx && continuations_[i]->size() != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Implementation of try_reclaim_continuation: pop back if still ours.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline bool BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::try_reclaim_continuation(std::coroutine_handle<> handle) {
+    std::coroutine_handle<> reclaimed;
+    return continuations_[current_index_]->try_pop_if(reclaimed,
+        [handle](std::coroutine_handle<> h) { return h == handle; });
 }
 
 /**
- * @brief Implementation of get_random: thread-safe RNG for queue selection.
+ * @brief Implementation of get_random: per-thread RNG for queue selection.
  */
-inline int ThreadPool::get_random() {
-    std::lock_guard<std::mutex> lck_guard(rand_mut);
-    std::uniform_int_distribution<int> dist(0, thread_count - 1);
-    return dist(mt);
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline int BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::get_random() {
+    static thread_local RandomVictim rng(std::random_device{}());
+    return rng.next(thread_count);
 }
 
 /**
  * @brief Implementation of submit: push task to random queue.
  */
-inline void ThreadPool::submit(TaskFunc func) {
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline void BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::submit(TaskFunc func) {
+    int i = get_random();
+    WSP_PROBE2(submit, this, i);
+    work_queues[i].push(TaggedTask(std::move(func))); 
+}
+
+/**
+ * @brief Implementation of tagged submit: push task and tag to a random queue.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline void BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::submit(TaskFunc func, const TaskTag& tag) {
+    int i = get_random();
+    WSP_PROBE2(submit, this, i);
+    work_queues[i].push(TaggedTask(std::move(func), &tag));
+}
+
+/**
+ * @brief Implementation of intrusive submit: link into a random worker's deque.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline void BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::submit(IntrusiveTask& task) {
+    int i = get_random();
+    task.tag_ = nullptr;
+    WSP_PROBE2(submit, this, i);
+    intrusive_queues_[i].push(&task);
+    wake_for_direct_work(i);
+}
+
+/**
+ * @brief Implementation of tagged intrusive submit.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline void BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::submit(IntrusiveTask& task, const TaskTag& tag) {
+    int i = get_random();
+    task.tag_ = &tag;
+    WSP_PROBE2(submit, this, i);
+    intrusive_queues_[i].push(&task);
+    wake_for_direct_work(i);
+}
+
+/**
+ * @brief Implementation of submit_with_deadline: queue on a random worker's EDF heap.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline void BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::submit_with_deadline(DeadlineQueue<TaggedTask>::Clock::time_point deadline,
+                                             TaskFunc func) {
+    int i = get_random();
+    WSP_PROBE2(submit, this, i);
+    deadline_queues_[i].push(deadline, TaggedTask(std::move(func)));
+    wake_for_direct_work(i);
+}
+
+/**
+ * @brief Implementation of tagged submit_with_deadline.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline void BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::submit_with_deadline(DeadlineQueue<TaggedTask>::Clock::time_point deadline,
+                                             TaskFunc func, const TaskTag& tag) {
     int i = get_random();
-    work_queues[i].push(std::move(func)); 
+    WSP_PROBE2(submit, this, i);
+    deadline_queues_[i].push(deadline, TaggedTask(std::move(func), &tag));
+    wake_for_direct_work(i);
+}
+
+/**
+ * @brief Implementation of deadline_stats: merge the per-worker counters.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline DeadlineStats BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::deadline_stats() const {
+    DeadlineStats stats;
+    uint64_t lateness_sum = 0;
+    for (int i = 0; i < thread_count; ++i) {
+        deadline_counters_[i].merge_into(stats, lateness_sum);
+    }
+    if (stats.missed > 0) {
+        stats.mean_lateness_ns = static_cast<double>(lateness_sum) / stats.missed;
+    }
+    return stats;
+}
+
+/**
+ * @brief Implementation of add_tenant.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline Tenant& BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::add_tenant(TenantOptions options) {
+    return tenants_.add(std::move(options));
+}
+
+/**
+ * @brief Implementation of tenant submit: admission control, then the tenant's FIFO.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline bool BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::submit(TaskFunc func, Tenant& tenant) {
+    // A worker must not block waiting for quota that only workers can release.
+    auto help = [this] {
+        if (!run_tenant_task(current_index_)) {
+            std::this_thread::yield();
+        }
+    };
+    if (!tenants_.admit(tenant, current_pool_ == this ? &help : nullptr)) {
+        return false;
+    }
+
+    tenants_.push(tenant, TaggedTask(std::move(func)));
+    wake_idle_worker();
+    return true;
+}
+
+/**
+ * @brief Implementation of tenant_stats.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline std::vector<TenantStats> BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::tenant_stats() {
+    return tenants_.stats();
+}
+
+/**
+ * @brief Implementation of callback read_async.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline void BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::read_async(int fd, void* buffer, size_t length, uint64_t offset, IoCallback done) {
+    submit_io(IoOp::read, fd, buffer, length, offset, std::move(done));
+}
+
+/**
+ * @brief Implementation of future read_async: the callback fulfils a shared promise.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline std::future<ssize_t> BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::read_async(int fd, void* buffer, size_t length, uint64_t offset) {
+    auto promise = std::make_shared<std::promise<ssize_t>>();
+    std::future<ssize_t> result = promise->get_future();
+    submit_io(IoOp::read, fd, buffer, length, offset, [promise](ssize_t n) { promise->set_value(n); });
+    return result;
+}
+
+/**
+ * @brief Implementation of callback write_async.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline void BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::write_async(int fd, const void* buffer, size_t length, uint64_t offset,
+                                    IoCallback done) {
+    submit_io(IoOp::write, fd, const_cast<void*>(buffer), length, offset, std::move(done));
+}
+
+/**
+ * @brief Implementation of future write_async.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline std::future<ssize_t> BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::write_async(int fd, const void* buffer, size_t length,
+                                                    uint64_t offset) {
+    auto promise = std::make_shared<std::promise<ssize_t>>();
+    std::future<ssize_t> result = promise->get_future();
+    submit_io(IoOp::write, fd, const_cast<void*>(buffer), length, offset,
+              [promise](ssize_t n) { promise->set_value(n); });
+    return result;
+}
+
+/**
+ * @brief Implementation of enable_task_timing.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline void BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::enable_task_timing(bool enabled) {
+    profiler_->set_enabled(enabled);
+}
+
+/**
+ * @brief Implementation of enable_task_counters.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline void BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::enable_task_counters(bool enabled) {
+    counters_->set_enabled(enabled);
+}
+
+/**
+ * @brief Implementation of counter_report: merge every worker's totals.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline CounterReport BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::counter_report() const {
+    return counters_->report();
+}
+
+/**
+ * @brief Implementation of scheduling_overhead_ns: time a burst of no-op tasks.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline double BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::scheduling_overhead_ns() {
+    constexpr int TASKS = 20000;
+
+    // Calibration tasks must not show up in the histograms being analysed.
+    bool timing = profiler_->enabled();
+    bool counting = counters_->enabled();
+    profiler_->set_enabled(false);
+    counters_->set_enabled(false);
+
+    // Roughly the capture size of a ConvolutionTask, so std::function allocates.
+    struct Payload { void* refs[4]; int range[2]; } payload{};
+    std::atomic<int> left{TASKS};
+
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < TASKS; ++t) {
+        submit([payload, &left] {
+            if (left.fetch_sub(1 + payload.range[0]) == 1) {
+                left.notify_one();
+            }
+        });
+    }
+    for (int remaining = left.load(); remaining != 0; remaining = left.load()) {
+        left.wait(remaining);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    profiler_->set_enabled(timing);
+    counters_->set_enabled(counting);
+    return std::chrono::duration<double, std::nano>(elapsed).count() / TASKS;
+}
+
+/**
+ * @brief Implementation of submit_latency: time single submissions after an idle gap.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline SubmitLatency BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::submit_latency(
+        int samples, std::chrono::microseconds gap) {
+    bool timing = profiler_->enabled();
+    bool counting = counters_->enabled();
+    profiler_->set_enabled(false);
+    counters_->set_enabled(false);
+
+    // Start time stamped by the task itself; 0 while it has not run yet
+    std::atomic<int64_t> started{0};
+    std::vector<double> latencies;
+    latencies.reserve(std::max(samples, 1));
+    for (int s = 0; s < samples; ++s) {
+        std::this_thread::sleep_for(gap);
+        started.store(0);
+        const auto submitted = std::chrono::steady_clock::now();
+        submit([&started] {
+            started.store(std::chrono::steady_clock::now().time_since_epoch().count());
+            started.notify_one();
+        });
+        for (int64_t t = started.load(); t == 0; t = started.load()) {
+            started.wait(0);
+        }
+        const std::chrono::steady_clock::duration latency(started.load() - submitted.time_since_epoch().count());
+        latencies.push_back(std::chrono::duration<double, std::nano>(latency).count());
+    }
+
+    profiler_->set_enabled(timing);
+    counters_->set_enabled(counting);
+
+    SubmitLatency result;
+    if (latencies.empty()) {
+        return result;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+        return latencies[std::min(latencies.size() - 1, static_cast<size_t>(p * latencies.size()))];
+    };
+    for (double ns : latencies) {
+        result.mean_ns += ns / latencies.size();
+    }
+    result.p50_ns = percentile(0.50);
+    result.p99_ns = percentile(0.99);
+    result.max_ns = latencies.back();
+    return result;
+}
+
+/**
+ * @brief Implementation of grain_report: merge histograms against the overhead estimate.
+ */
+template <class QueuePolicy, class IdlePolicy, class VictimPolicy>
+inline GrainReport BasicThreadPool<QueuePolicy, IdlePolicy, VictimPolicy>::grain_report(double target_share) {
+    return profiler_->report(scheduling_overhead_ns(), target_share);
 }
 
 /**
@@ -4,10 +4,15 @@
 #include <deque>
 #include <memory>
 #include <mutex>
-#include <condition_variable>
 #include <atomic>
+#include <chrono>
+#include <climits>
 #include <iostream>
 
+#include "futex.hpp"
+#include "node_arena.hpp"
+#include "sdt_probes.hpp"
+
 using namespace std::literals;
 
 /**
@@ -18,9 +23,16 @@ using namespace std::literals;
  * a work-stealing thread-pool. The owner of the deque performs LIFO
  * operations (push/pop at the back) while other threads may "steal" work
  * from the front (FIFO). The implementation internally uses
- * `std::deque<std::unique_ptr<T>>` to efficiently move and manage task objects.
+ * `std::deque<std::unique_ptr<T>>` to efficiently move and manage task objects;
+ * the elements are allocated from the pooled, huge-page backed `NodeArena`.
+ *
+ * Blocked pushers and poppers park on futex words (`futex.hpp`) rather than
+ * condition variables. Waiter counts, kept under the mutex, let pushes and pops
+ * skip the wake-up entirely when nobody waits, so uncontended operations make
+ * no system calls. Wake-ups are issued after the mutex is released.
  *
- * @note This file has no external dependencies beyond the standard library.
+ * Pushes, pops and steals (successful or not) fire the `wsp:deque_push`,
+ * `wsp:deque_pop` and `wsp:deque_steal` static probes (`sdt_probes.hpp`).
  *
  * @author dssregi
  * @version 1.0
@@ -45,23 +57,28 @@ using namespace std::literals;
  * @thread_safety The class is safe for concurrent use: multiple threads may
  *                call stealing methods while a single owner thread performs
  *                owner operations. Internal synchronization is implemented
- *                with `std::mutex` and `std::condition_variable`.
+ *                with `std::mutex` and futex-based parking.
  */
 template <class T>
 class ThreadSafeDeque {
 private:
     /**
-     * @brief Mutex protecting the internal deque and condition variables.
+     * @brief Mutex protecting the internal deque and the waiter counts.
      */
     std::mutex mut_;
 
+    /**
+     * @brief Owning pointer to an element allocated with `arena_new`.
+     */
+    using Entry = std::unique_ptr<T, ArenaDelete>;
+
     /**
      * @brief Container holding the tasks as owning pointers.
      *
-     * Using `std::unique_ptr<T>` avoids copies and clearly transfers
+     * Using `std::unique_ptr` avoids copies and clearly transfers
      * ownership when elements are popped or stolen.
      */
-    std::deque<std::unique_ptr<T>> deque_;
+    std::deque<Entry> deque_;
 
     /**
      * @brief Maximum number of elements allowed in the deque before `push`
@@ -70,20 +87,111 @@ private:
     const size_t max_size_;
     
     /**
-     * @brief Condition variable signalled when the deque becomes non-empty.
+     * @brief Futex word bumped when the deque becomes non-empty and a popper waits.
      */
-    std::condition_variable cv_not_empty_;
+    std::atomic<uint32_t> not_empty_word_{0};
 
     /**
-     * @brief Condition variable signalled when the deque has space for pushes.
+     * @brief Futex word bumped when the deque has space and a pusher waits.
      */
-    std::condition_variable cv_not_full_;
+    std::atomic<uint32_t> not_full_word_{0};
+
+    /**
+     * @brief Parked threads of one kind, and how many of them have been woken
+     *        but have not yet re-acquired the mutex; guarded by `mut_`.
+     */
+    struct Waiters {
+        int waiting = 0;
+        int signalled = 0;
+    };
+
+    /**
+     * @brief Threads parked (or about to park) in `wait_and_pop`.
+     */
+    Waiters empty_waiters_;
+
+    /**
+     * @brief Threads parked (or about to park) in a full `push`.
+     */
+    Waiters full_waiters_;
     
     /**
      * @brief When true, the deque is closed and blocking waits should return.
      */
     bool done_ = false;
 
+    /**
+     * @brief Park on @p word until @p ready holds or @p deadline passes.
+     *
+     * Called and returns with @p lock held. The word is sampled under the lock
+     * and only bumped under it, so a signal sent after the lock is released
+     * changes the word before the futex call can sleep on the old value.
+     *
+     * @return Whether @p ready holds on return.
+     */
+    template <class Ready>
+    bool park(std::unique_lock<std::mutex>& lock, std::atomic<uint32_t>& word, Waiters& waiters, Ready ready,
+              const timespec* deadline) {
+        while (!ready()) {
+            ++waiters.waiting;
+            const uint32_t seq = word.load(std::memory_order_relaxed);
+            lock.unlock();
+            const bool in_time = futex_wait(word, seq, deadline);
+            lock.lock();
+            --waiters.waiting;
+            if (waiters.signalled > 0) {
+                --waiters.signalled;
+            }
+            if (!in_time) {
+                return ready();
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Release @p lock, then wake one thread parked on @p word unless every
+     *        waiter has already been woken.
+     *
+     * Each wake makes at least one waiter return, and each returning waiter
+     * retires at most one signal, so `signalled` never overstates the pending
+     * wake-ups and no waiter is left asleep. A consumer draining a full deque
+     * thus wakes the blocked producer once, not once per pop.
+     */
+    static void unlock_and_signal(std::unique_lock<std::mutex>& lock, std::atomic<uint32_t>& word, Waiters& waiters) {
+        const bool wake = waiters.waiting > waiters.signalled;
+        if (wake) {
+            ++waiters.signalled;
+            word.fetch_add(1, std::memory_order_relaxed);
+        }
+        lock.unlock();
+        if (wake) {
+            futex_wake(word, 1);
+        }
+    }
+
+    /**
+     * @brief Move out the back element (lock held), release the lock and wake a pusher.
+     */
+    void take_back(std::unique_lock<std::mutex>& lock, T& value) {
+        Entry data_ptr = std::move(deque_.back());
+        deque_.pop_back();
+        WSP_PROBE1(deque_pop, this);
+        unlock_and_signal(lock, not_full_word_, full_waiters_);
+        value = std::move(*data_ptr);
+    }
+
+    /**
+     * @brief Move out the front element (lock held), release the lock and wake a pusher.
+     */
+    void take_front(std::unique_lock<std::mutex>& lock, T& value) {
+        Entry data_ptr = std::move(deque_.front());
+        deque_.pop_front();
+        WSP_PROBE2(deque_steal, this, true);
+        unlock_and_signal(lock, not_full_word_, full_waiters_);
+        value = std::move(*data_ptr);
+    }
+
 public:
     /**
      * @brief Construct a ThreadSafeDeque with a maximum capacity.
@@ -114,17 +222,18 @@ public:
      *       the value will not be stored.
      */
     void push(T value) {
-        std::unique_ptr<T> data_ptr = std::make_unique<T>(std::move(value));
+        Entry data_ptr(arena_new<T>(std::move(value)));
 
         std::unique_lock<std::mutex> lock(mut_);
-        cv_not_full_.wait(lock, [this]{ return done_ || deque_.size() < max_size_; });
+        park(lock, not_full_word_, full_waiters_, [this]{ return done_ || deque_.size() < max_size_; }, nullptr);
 
         if (done_) { 
             return; 
         }
 
         deque_.push_back(std::move(data_ptr)); // LIFO Push to back
-        cv_not_empty_.notify_one();
+        WSP_PROBE2(deque_push, this, deque_.size());
+        unlock_and_signal(lock, not_empty_word_, empty_waiters_);
     }
 
     /**
@@ -134,21 +243,39 @@ public:
      * @return true if an element was popped, false if the deque was empty.
      */
     bool try_pop(T& value) {
-        std::lock_guard<std::mutex> lock(mut_);
+        std::unique_lock<std::mutex> lock(mut_);
         
         if (deque_.empty()) {
             return false;
         }
         
         // LIFO Pop from back (improves cache locality for the owner)
-        std::unique_ptr<T> data_ptr = std::move(deque_.back());
-        deque_.pop_back();
-        
-        value = std::move(*data_ptr); 
-        cv_not_full_.notify_one(); 
+        take_back(lock, value);
         return true;
     }
     
+    /**
+     * @brief Pop the back element only if it satisfies a predicate (owner LIFO pop).
+     *
+     * Used to reclaim a specific item the owner pushed earlier, e.g. a parent
+     * continuation that has not been stolen in the meantime.
+     *
+     * @param[out] value Where the popped value is placed if pop succeeds.
+     * @param pred Predicate evaluated on the back element under the lock.
+     * @return true if the back element matched and was popped, false otherwise.
+     */
+    template <class Pred>
+    bool try_pop_if(T& value, Pred pred) {
+        std::unique_lock<std::mutex> lock(mut_);
+
+        if (deque_.empty() || !pred(*deque_.back())) {
+            return false;
+        }
+
+        take_back(lock, value);
+        return true;
+    }
+
     /**
      * @brief Try to steal an element from the front (non-owner FIFO pop) without blocking.
      *
@@ -158,18 +285,37 @@ public:
      * @return true if an element was stolen, false if the deque was empty.
      */
     bool try_steal(T& value) {
-        std::lock_guard<std::mutex> lock(mut_);
+        std::unique_lock<std::mutex> lock(mut_);
         
         if (deque_.empty()) {
+            WSP_PROBE2(deque_steal, this, false);
             return false;
         }
 
         // FIFO Pop from front (stealing the oldest work)
-        std::unique_ptr<T> data_ptr = std::move(deque_.front());
-        deque_.pop_front();
+        take_front(lock, value);
+        return true;
+    }
 
-        value = std::move(*data_ptr);
-        cv_not_full_.notify_one();
+    /**
+     * @brief Steal the front element only if it satisfies a predicate (non-owner FIFO pop).
+     *
+     * Lets thieves leave alone entries addressed to the owner, e.g. wake-up nudges.
+     *
+     * @param[out] value Where the stolen value is placed if steal succeeds.
+     * @param pred Predicate evaluated on the front element under the lock.
+     * @return true if the front element matched and was stolen, false otherwise.
+     */
+    template <class Pred>
+    bool try_steal_if(T& value, Pred pred) {
+        std::unique_lock<std::mutex> lock(mut_);
+
+        if (deque_.empty() || !pred(*deque_.front())) {
+            WSP_PROBE2(deque_steal, this, false);
+            return false;
+        }
+
+        take_front(lock, value);
         return true;
     }
 
@@ -185,21 +331,54 @@ public:
     bool wait_and_pop(T& value) {
         std::unique_lock<std::mutex> lock(mut_);
         
-        cv_not_empty_.wait(lock, [this]{ return done_ || !deque_.empty(); });
+        park(lock, not_empty_word_, empty_waiters_, [this]{ return done_ || !deque_.empty(); }, nullptr);
 
         if (done_ && deque_.empty()) {
             return false; 
         }
 
         // LIFO Pop from back
-        std::unique_ptr<T> data_ptr = std::move(deque_.back());
-        deque_.pop_back();
+        take_back(lock, value);
+        return true;
+    }
 
-        value = std::move(*data_ptr);
-        cv_not_full_.notify_one();
+    /**
+     * @brief Wait until an element is available or a deadline passes, then pop from the back.
+     *
+     * Timed variant of `wait_and_pop`, used by workers that must wake up in time to
+     * service an expiring timer.
+     *
+     * @param[out] value Where the popped value is placed if pop succeeds.
+     * @param deadline Absolute time after which the wait gives up.
+     * @return true if an element was popped, false on timeout or if the deque was
+     *         closed and empty.
+     */
+    template <class Clock, class Duration>
+    bool wait_and_pop_until(T& value, const std::chrono::time_point<Clock, Duration>& deadline) {
+        const timespec abs = to_monotonic_timespec(deadline);
+        std::unique_lock<std::mutex> lock(mut_);
+
+        if (!park(lock, not_empty_word_, empty_waiters_, [this]{ return done_ || !deque_.empty(); }, &abs)) {
+            return false;
+        }
+
+        if (deque_.empty()) {
+            return false;
+        }
+
+        // LIFO Pop from back
+        take_back(lock, value);
         return true;
     }
 
+    /**
+     * @brief Number of queued elements (for monitoring).
+     */
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mut_);
+        return deque_.size();
+    }
+
     /**
      * @brief Close the deque and wake any blocking waiters.
      *
@@ -207,10 +386,16 @@ public:
      * return (push will no-op, wait_and_pop will return false if empty).
      */
     void close() {
-        std::lock_guard<std::mutex> lock(mut_);
-        done_ = true;
-        cv_not_empty_.notify_all(); 
-        cv_not_full_.notify_all();  
+        {
+            std::lock_guard<std::mutex> lock(mut_);
+            done_ = true;
+            empty_waiters_.signalled = empty_waiters_.waiting;
+            full_waiters_.signalled = full_waiters_.waiting;
+            not_empty_word_.fetch_add(1, std::memory_order_relaxed);
+            not_full_word_.fetch_add(1, std::memory_order_relaxed);
+        }
+        futex_wake(not_empty_word_, INT_MAX);
+        futex_wake(not_full_word_, INT_MAX);
     }
 };
 
@@ -0,0 +1,448 @@
+#ifndef __TIMER_WHEEL_HPP__
+#define __TIMER_WHEEL_HPP__
+
+#include <array>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <bit>
+
+/**
+ * @file timer_wheel.hpp
+ * @brief Hierarchical timer wheel used for delayed and periodic task submission.
+ *
+ * This header provides a small hierarchical (hashed) timer wheel in the style of
+ * Varghese & Lauck. Timers are bucketed by their expiry tick into one of several
+ * levels of 64 slots each; level 0 has single-tick granularity, every higher level
+ * is 64 times coarser. Timers in coarse slots are cascaded into finer levels as
+ * time approaches their expiry, so both insertion and expiry are O(1) amortised.
+ *
+ * @details
+ * - The wheel does not own a thread. Whoever calls `advance()` (the idle workers
+ *   of `ThreadPool`) collects the expired tasks and decides where to run them.
+ * - `next_expiry()` is lock-free so a parking worker can bound its wait by the
+ *   next expiry without contending on the wheel mutex.
+ * - Timers further away than the top level can represent are kept in an overflow
+ *   bucket and re-inserted whenever the top level wraps around.
+ * - Every timer gets a `TimerId`, with which it can be cancelled.
+ *
+ * @author dssregi
+ * @version 1.0
+ * @date 2025-11-14
+ */
+
+/**
+ * @brief Identifier of an armed timer, see `TimerWheel::cancel`; 0 is never used.
+ */
+using TimerId = uint64_t;
+
+/**
+ * @brief Thread-safe hierarchical timer wheel holding one-shot and periodic tasks.
+ *
+ * @tparam T Type of the task stored with each timer. Must be MoveConstructible;
+ *           periodic timers additionally require `T` to be CopyConstructible since
+ *           a copy is handed out on every expiry.
+ *
+ * @details
+ * Slots are indexed by the absolute expiry tick: a timer lives on the level of
+ * the most significant 6-bit digit in which its expiry differs from the wheel's
+ * current tick. A level-L slot is therefore only visited when the current tick's
+ * lower digits roll over to zero, at which point its timers are re-inserted one or
+ * more levels down. Because the wheel may be advanced lazily (only when a worker
+ * is idle), `advance()` jumps straight to the next non-empty slot instead of
+ * walking every elapsed tick.
+ *
+ * @thread_safety All public methods are safe to call concurrently. Mutation is
+ *                serialized by an internal mutex; `advance()` only try-locks so
+ *                several idle workers never queue up behind each other.
+ */
+template <class T>
+class TimerWheel {
+public:
+    /**
+     * @brief Monotonic clock used for all deadlines.
+     */
+    using Clock = std::chrono::steady_clock;
+
+private:
+    /**
+     * @brief Number of tick bits resolved by each level (64 slots per level).
+     */
+    static constexpr int LEVEL_BITS = 6;
+
+    /**
+     * @brief Number of slots per level.
+     */
+    static constexpr int SLOTS = 1 << LEVEL_BITS;
+
+    /**
+     * @brief Number of levels; spans 2^24 ticks (~4.6 hours at 1 ms) before overflow.
+     */
+    static constexpr int LEVELS = 4;
+
+    /**
+     * @brief Sentinel published through `next_tick_` when no timer is armed.
+     */
+    static constexpr uint64_t NO_TIMER = std::numeric_limits<uint64_t>::max();
+
+    /**
+     * @brief A single armed timer.
+     */
+    struct Timer {
+        TimerId id;        ///< Identifier returned by `schedule`.
+        uint64_t deadline; ///< Absolute expiry tick.
+        uint64_t period;   ///< Re-arm interval in ticks, or 0 for one-shot timers.
+        T task;            ///< Task handed out on expiry.
+    };
+
+    /**
+     * @brief Mutex protecting every field below except `next_tick_`.
+     */
+    std::mutex mut_;
+
+    /**
+     * @brief Time point corresponding to tick 0.
+     */
+    const Clock::time_point epoch_;
+
+    /**
+     * @brief Duration of a single tick.
+     */
+    const Clock::duration resolution_;
+
+    /**
+     * @brief Last tick processed by `advance()`. All armed timers expire after it.
+     */
+    uint64_t current_tick_ = 0;
+
+    /**
+     * @brief Timer slots, `slots_[level][slot]`.
+     */
+    std::array<std::array<std::vector<Timer>, SLOTS>, LEVELS> slots_;
+
+    /**
+     * @brief Per-level bitmap of non-empty slots, used to find the next expiry quickly.
+     */
+    std::array<uint64_t, LEVELS> occupied_{};
+
+    /**
+     * @brief Timers whose expiry lies beyond the range of the top level.
+     */
+    std::vector<Timer> overflow_;
+
+    /**
+     * @brief Total number of armed timers.
+     */
+    size_t size_ = 0;
+
+    /**
+     * @brief Identifier given to the next scheduled timer.
+     */
+    TimerId next_id_ = 1;
+
+    /**
+     * @brief Lower bound of the next expiry tick, published for lock-free readers.
+     */
+    std::atomic<uint64_t> next_tick_{NO_TIMER};
+
+    /**
+     * @brief Convert a time point into a tick, rounding up so timers never fire early.
+     */
+    uint64_t to_tick_ceil(Clock::time_point tp) const {
+        if (tp <= epoch_) {
+            return 0;
+        }
+        return static_cast<uint64_t>((tp - epoch_ + resolution_ - Clock::duration(1)) / resolution_);
+    }
+
+    /**
+     * @brief Convert a time point into a tick, rounding down (ticks that have fully elapsed).
+     */
+    uint64_t to_tick_floor(Clock::time_point tp) const {
+        if (tp <= epoch_) {
+            return 0;
+        }
+        return static_cast<uint64_t>((tp - epoch_) / resolution_);
+    }
+
+    /**
+     * @brief Place a timer into the slot matching its deadline relative to `current_tick_`.
+     *
+     * Timers that are already due are appended to @p due instead.
+     */
+    void insert_locked(Timer&& timer, std::vector<T>& due) {
+        if (timer.deadline <= current_tick_) {
+            expire_locked(std::move(timer), due);
+            return;
+        }
+
+        const uint64_t diff = timer.deadline ^ current_tick_;
+        const int level = (63 - std::countl_zero(diff)) / LEVEL_BITS;
+
+        if (level >= LEVELS) {
+            overflow_.push_back(std::move(timer));
+            return;
+        }
+
+        const int slot = static_cast<int>((timer.deadline >> (level * LEVEL_BITS)) & (SLOTS - 1));
+        slots_[level][slot].push_back(std::move(timer));
+        occupied_[level] |= uint64_t(1) << slot;
+    }
+
+    /**
+     * @brief Hand out an expired timer's task, re-arming it if it is periodic.
+     */
+    void expire_locked(Timer&& timer, std::vector<T>& due) {
+        --size_;
+
+        if (timer.period == 0) {
+            due.push_back(std::move(timer.task));
+            return;
+        }
+
+        due.push_back(timer.task);
+
+        // Fixed-rate re-arm; periods missed while nobody advanced the wheel are skipped.
+        timer.deadline = std::max(timer.deadline + timer.period, current_tick_ + 1);
+        ++size_;
+        insert_locked(std::move(timer), due);
+    }
+
+    /**
+     * @brief Move every timer out of a bucket and re-insert it relative to `current_tick_`.
+     */
+    void cascade_locked(std::vector<Timer>& bucket, std::vector<T>& due) {
+        std::vector<Timer> timers = std::move(bucket);
+        bucket.clear();
+        for (Timer& timer : timers) {
+            insert_locked(std::move(timer), due);
+        }
+    }
+
+    /**
+     * @brief Process every slot whose processing moment is exactly `current_tick_`.
+     */
+    void process_tick_locked(std::vector<T>& due) {
+        const uint64_t t = current_tick_;
+
+        if ((t & ((uint64_t(1) << (LEVELS * LEVEL_BITS)) - 1)) == 0 && !overflow_.empty()) {
+            cascade_locked(overflow_, due);
+        }
+
+        // Cascade coarse levels first so their timers land in the finer slots processed below.
+        for (int level = LEVELS - 1; level > 0; --level) {
+            if ((t & ((uint64_t(1) << (level * LEVEL_BITS)) - 1)) != 0) {
+                continue;
+            }
+            const int slot = static_cast<int>((t >> (level * LEVEL_BITS)) & (SLOTS - 1));
+            if (occupied_[level] & (uint64_t(1) << slot)) {
+                occupied_[level] &= ~(uint64_t(1) << slot);
+                cascade_locked(slots_[level][slot], due);
+            }
+        }
+
+        const int slot = static_cast<int>(t & (SLOTS - 1));
+        if (occupied_[0] & (uint64_t(1) << slot)) {
+            occupied_[0] &= ~(uint64_t(1) << slot);
+            std::vector<Timer> timers = std::move(slots_[0][slot]);
+            slots_[0][slot].clear();
+            for (Timer& timer : timers) {
+                expire_locked(std::move(timer), due);
+            }
+        }
+    }
+
+    /**
+     * @brief Compute the earliest tick at which some slot must be processed.
+     *
+     * For level 0 this is the exact expiry; for coarser levels it is the tick at
+     * which the slot is cascaded, which is a lower bound of the real expiry.
+     */
+    uint64_t compute_next_locked() const {
+        if (size_ == 0) {
+            return NO_TIMER;
+        }
+
+        uint64_t next = NO_TIMER;
+        if (!overflow_.empty()) {
+            next = ((current_tick_ >> (LEVELS * LEVEL_BITS)) + 1) << (LEVELS * LEVEL_BITS);
+        }
+
+        for (int level = 0; level < LEVELS; ++level) {
+            const int shift = level * LEVEL_BITS;
+            const int digit = static_cast<int>((current_tick_ >> shift) & (SLOTS - 1));
+            if (digit == SLOTS - 1) {
+                continue;
+            }
+            const uint64_t pending = occupied_[level] & (~uint64_t(0) << (digit + 1));
+            if (pending == 0) {
+                continue;
+            }
+            const uint64_t slot = static_cast<uint64_t>(std::countr_zero(pending));
+            const uint64_t base = (current_tick_ >> (shift + LEVEL_BITS)) << (shift + LEVEL_BITS);
+            next = std::min(next, base | (slot << shift));
+        }
+        return next;
+    }
+
+public:
+    /**
+     * @brief Construct an empty timer wheel.
+     *
+     * @param resolution Duration of one tick. Timers fire no earlier than requested
+     *                   and at most one tick (plus wake-up latency) late.
+     */
+    explicit TimerWheel(Clock::duration resolution = std::chrono::milliseconds(1))
+        : epoch_(Clock::now()), resolution_(resolution) {}
+
+    /**
+     * @brief Disable copy construction.
+     */
+    TimerWheel(const TimerWheel&) = delete;
+
+    /**
+     * @brief Disable copy assignment.
+     */
+    TimerWheel& operator =(const TimerWheel&) = delete;
+
+    /**
+     * @brief Arm a timer.
+     *
+     * @param delay Time from now until the first expiry.
+     * @param period Re-arm interval for periodic timers, or zero for a one-shot timer.
+     * @param task Task handed out by `advance()` on every expiry.
+     * @param[out] id If not null, receives the identifier to pass to `cancel`.
+     * @return true if the new timer became the earliest one, i.e. a waiter bounded by
+     *         the previous `next_expiry()` should be woken to re-evaluate its timeout.
+     */
+    bool schedule(Clock::duration delay, Clock::duration period, T task, TimerId* id = nullptr) {
+        const Clock::time_point now = Clock::now();
+
+        std::lock_guard<std::mutex> lock(mut_);
+
+        if (id) {
+            *id = next_id_;
+        }
+        Timer timer{
+            next_id_++,
+            std::max(to_tick_ceil(now + delay), current_tick_ + 1),
+            period > Clock::duration::zero() ? std::max<uint64_t>(1, to_tick_ceil(epoch_ + period)) : 0,
+            std::move(task)
+        };
+
+        const uint64_t deadline = timer.deadline;
+        std::vector<T> unused;
+        ++size_;
+        insert_locked(std::move(timer), unused);
+
+        const uint64_t previous = next_tick_.load(std::memory_order_relaxed);
+        next_tick_.store(compute_next_locked());
+        return deadline < previous;
+    }
+
+    /**
+     * @brief Disarm a timer.
+     *
+     * A task already handed out by `advance()` is not recalled, so a run released
+     * just before the call may still execute.
+     *
+     * @param id Identifier received from `schedule`.
+     * @return true if the timer was armed and is now removed, false if it had
+     *         already fired (one-shot) or been cancelled.
+     */
+    bool cancel(TimerId id) {
+        std::lock_guard<std::mutex> lock(mut_);
+
+        auto remove = [id](std::vector<Timer>& bucket) {
+            auto it = std::find_if(bucket.begin(), bucket.end(), [id](const Timer& t) { return t.id == id; });
+            if (it == bucket.end()) {
+                return false;
+            }
+            bucket.erase(it);
+            return true;
+        };
+
+        bool found = remove(overflow_);
+        for (int level = 0; level < LEVELS && !found; ++level) {
+            for (uint64_t bits = occupied_[level]; bits != 0 && !found; bits &= bits - 1) {
+                const int slot = std::countr_zero(bits);
+                if (remove(slots_[level][slot])) {
+                    found = true;
+                    if (slots_[level][slot].empty()) {
+                        occupied_[level] &= ~(uint64_t(1) << slot);
+                    }
+                }
+            }
+        }
+        if (!found) {
+            return false;
+        }
+
+        --size_;
+        next_tick_.store(compute_next_locked());
+        return true;
+    }
+
+    /**
+     * @brief Advance the wheel to the current time and collect expired tasks.
+     *
+     * @param[out] due Expired tasks are appended here, in expiry order.
+     * @return Number of tasks appended. Returns 0 without waiting if another thread
+     *         is currently advancing the wheel.
+     */
+    size_t advance(std::vector<T>& due) {
+        if (next_tick_.load() == NO_TIMER) {
+            return 0;
+        }
+
+        std::unique_lock<std::mutex> lock(mut_, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            return 0;
+        }
+
+        const size_t before = due.size();
+        const uint64_t target = to_tick_floor(Clock::now());
+
+        while (current_tick_ < target) {
+            const uint64_t next = compute_next_locked();
+            if (next > target) {
+                current_tick_ = target;
+                break;
+            }
+            current_tick_ = next;
+            process_tick_locked(due);
+        }
+
+        next_tick_.store(compute_next_locked());
+        return due.size() - before;
+    }
+
+    /**
+     * @brief Lower bound of the time at which `advance()` next has work to do.
+     *
+     * @return The next expiry (or cascade point), or `std::nullopt` if no timer is armed.
+     */
+    std::optional<Clock::time_point> next_expiry() const {
+        const uint64_t tick = next_tick_.load();
+        if (tick == NO_TIMER) {
+            return std::nullopt;
+        }
+        return epoch_ + resolution_ * static_cast<Clock::rep>(tick);
+    }
+
+    /**
+     * @brief Check whether any timer is armed.
+     *
+     * @return true if no timer is armed.
+     */
+    bool empty() const {
+        return next_tick_.load() == NO_TIMER;
+    }
+};
+
+#endif // __TIMER_WHEEL_HPP__
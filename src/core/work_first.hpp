@@ -0,0 +1,483 @@
+#ifndef __WORK_FIRST_HPP__
+#define __WORK_FIRST_HPP__
+
+#include <coroutine>
+#include <atomic>
+#include <exception>
+#include <optional>
+#include <utility>
+#include <mutex>
+#include <condition_variable>
+
+#include "thread_pool.hpp"
+
+/**
+ * @file work_first.hpp
+ * @brief Work-first (continuation-stealing) spawn mode built on C++20 coroutines.
+ *
+ * The pool's `submit` is help-first: the child is queued and the parent keeps
+ * running, so a deep divide-and-conquer recursion fills the deques with children.
+ * This header adds the Cilk-style alternative. A `WorkFirstTask` coroutine that
+ * `co_await spawn(child)`s publishes its own continuation on the worker's
+ * continuation deque and runs the child immediately. Idle workers steal the
+ * continuation, not the child.
+ *
+ * @details
+ * - If nobody steals, the child returns by popping its parent back off the deque
+ *   and resuming it directly: execution order and stack depth equal the serial
+ *   program, and deque space is bounded by the recursion depth.
+ * - `co_await join()` waits until all children spawned by the current coroutine
+ *   have completed. Whoever finishes last (the parent or a child on another
+ *   worker) resumes the code after the join.
+ * - `co_await child` calls a task serially; `sync_wait(pool, task)` runs a root
+ *   task on the pool from a non-worker thread and blocks until it completes.
+ * - Tasks name the pool variant they run on (`WorkFirstTask<T, Pool>`, default
+ *   `ThreadPool`), because continuations live in that variant's deques. A tree
+ *   can only be started on a pool of its own variant; a spawn on any other
+ *   thread (outside a worker of that variant) runs the child as a call.
+ * - Control transfers between coroutines go through `BasicThreadPool::transfer_to`
+ *   and the worker's `run_continuation` loop rather than symmetric transfer, so
+ *   stack usage does not depend on the compiler emitting tail calls.
+ *
+ * Example:
+ * @code
+ * WorkFirstTask<long> fib(int n) {
+ *     if (n < 2) co_return n;
+ *     WorkFirstTask<long> a = fib(n - 1);
+ *     WorkFirstTask<long> b = fib(n - 2);
+ *     co_await spawn(a);
+ *     long y = co_await b;
+ *     co_await join();
+ *     co_return a.get() + y;
+ * }
+ * long r = sync_wait(pool, fib(30));
+ *
+ * // The same recursion on the lock-free variant
+ * WorkFirstTask<long, ThroughputThreadPool> fib_lf(int n);
+ * @endcode
+ *
+ * @author dssregi
+ * @version 1.0
+ * @date 2025-11-14
+ */
+
+template <class T = void, class Pool = ThreadPool> class WorkFirstTask;
+
+/**
+ * @brief Completion signal for a root task driven by `sync_wait`.
+ *
+ * The flag is set and the condition variable notified under the mutex so the
+ * waiting thread cannot destroy the signal while the notifier still uses it.
+ */
+struct WorkFirstRootSignal {
+    std::mutex mut;              ///< Protects `done`.
+    std::condition_variable cv;  ///< Signalled when the root task completes.
+    bool done = false;           ///< Set once the root task reached its final suspend point.
+};
+
+/**
+ * @brief State shared by all work-first promise types, independent of the result type.
+ *
+ * @tparam Pool Pool variant whose workers run the task tree.
+ *
+ * @details
+ * `join_count_` starts at 1 (the coroutine itself) and is incremented for each
+ * spawned child. A finishing child decrements it; `join()` decrements the
+ * coroutine's own unit. Whoever brings it from 1 to 0 resumes the code after the
+ * join, after which the count is reset to 1.
+ */
+template <class Pool>
+class WorkFirstPromiseBase {
+public:
+    /**
+     * @brief How the coroutine was started, which decides where it returns to.
+     */
+    enum class Mode {
+        root,    ///< Started by `sync_wait`; signals `root_signal_` on completion.
+        called,  ///< Awaited directly; resumes the caller on completion.
+        spawned  ///< Spawned work-first; reclaims or joins the parent on completion.
+    };
+
+    /**
+     * @brief Start mode, set by the awaiter that starts the coroutine.
+     */
+    Mode mode_ = Mode::root;
+
+    /**
+     * @brief Handle of the coroutine to return to (called and spawned modes).
+     */
+    std::coroutine_handle<> parent_;
+
+    /**
+     * @brief Promise of the parent, used to decrement its join count.
+     */
+    WorkFirstPromiseBase* parent_promise_ = nullptr;
+
+    /**
+     * @brief Signal to raise on completion (root mode).
+     */
+    WorkFirstRootSignal* root_signal_ = nullptr;
+
+    /**
+     * @brief Outstanding spawned children plus one for the coroutine itself.
+     */
+    std::atomic<int> join_count_{1};
+
+    /**
+     * @brief Exception escaping the coroutine body, rethrown by `get()`.
+     */
+    std::exception_ptr exception_;
+
+    /**
+     * @brief Final awaiter: return control to the parent, a joiner, or the worker loop.
+     *
+     * Nothing in the finishing coroutine's frame is touched after the parent's
+     * join count is decremented, because the parent may destroy the frame as soon
+     * as it observes the decrement.
+     */
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+
+        template <class Promise>
+        void await_suspend(std::coroutine_handle<Promise> self) noexcept {
+            WorkFirstPromiseBase& promise = self.promise();
+
+            if (promise.mode_ == Mode::root) {
+                WorkFirstRootSignal* signal = promise.root_signal_;
+                std::lock_guard<std::mutex> lock(signal->mut);
+                signal->done = true;
+                signal->cv.notify_one();
+                return;
+            }
+
+            std::coroutine_handle<> parent = promise.parent_;
+            if (promise.mode_ == Mode::called) {
+                Pool::transfer_to(parent);
+                return;
+            }
+
+            WorkFirstPromiseBase* parent_promise = promise.parent_promise_;
+            Pool* pool = Pool::current();
+
+            // Not stolen: continue the parent serially on this worker.
+            if (pool != nullptr && pool->try_reclaim_continuation(parent)) {
+                parent_promise->join_count_.fetch_sub(1, std::memory_order_acq_rel);
+                Pool::transfer_to(parent);
+                return;
+            }
+
+            // Stolen: the parent runs elsewhere; resume it only if it is waiting in join().
+            if (parent_promise->join_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                Pool::transfer_to(parent);
+            }
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    /**
+     * @brief Tasks are lazy: nothing runs until spawned, awaited or passed to `sync_wait`.
+     */
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+
+    /**
+     * @brief Hand control back according to the start mode.
+     */
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+
+    /**
+     * @brief Capture an exception escaping the coroutine body.
+     */
+    void unhandled_exception() noexcept { exception_ = std::current_exception(); }
+
+    /**
+     * @brief Rethrow a captured exception, if any.
+     */
+    void rethrow_if_failed() const {
+        if (exception_) {
+            std::rethrow_exception(exception_);
+        }
+    }
+};
+
+/**
+ * @brief Promise type of `WorkFirstTask<T, Pool>` for value-returning tasks.
+ *
+ * @tparam T Result type; must be MoveConstructible.
+ * @tparam Pool Pool variant whose workers run the task tree.
+ */
+template <class T, class Pool>
+class WorkFirstPromise : public WorkFirstPromiseBase<Pool> {
+public:
+    /**
+     * @brief Result stored by `co_return`.
+     */
+    std::optional<T> value_;
+
+    WorkFirstTask<T, Pool> get_return_object() noexcept;
+
+    template <class U>
+    void return_value(U&& value) { value_.emplace(std::forward<U>(value)); }
+
+    /**
+     * @brief Move the result out, rethrowing a captured exception.
+     */
+    T take() {
+        this->rethrow_if_failed();
+        return std::move(*value_);
+    }
+};
+
+/**
+ * @brief Promise type of `WorkFirstTask<void, Pool>`.
+ */
+template <class Pool>
+class WorkFirstPromise<void, Pool> : public WorkFirstPromiseBase<Pool> {
+public:
+    WorkFirstTask<void, Pool> get_return_object() noexcept;
+
+    void return_void() noexcept {}
+
+    /**
+     * @brief Rethrow a captured exception, if any.
+     */
+    void take() { this->rethrow_if_failed(); }
+};
+
+/**
+ * @brief Lazily started coroutine task for the work-first spawn mode.
+ *
+ * @tparam T Result type produced by `co_return` (may be `void`).
+ * @tparam Pool Pool variant whose workers run the task tree.
+ *
+ * @details
+ * The task object owns the coroutine frame and destroys it when it goes out of
+ * scope, so a parent must keep spawned children alive until it has joined them.
+ * Tasks are move-only.
+ *
+ * @thread_safety A task is driven by exactly one thread at a time; the pool
+ *                migrates it between workers only at suspension points.
+ */
+template <class T, class Pool>
+class WorkFirstTask {
+public:
+    using promise_type = WorkFirstPromise<T, Pool>;
+
+private:
+    /**
+     * @brief Owned coroutine frame.
+     */
+    std::coroutine_handle<promise_type> handle_;
+
+    template <class U, class P> friend class WorkFirstSpawnAwaiter;
+    template <class U, class P> friend U sync_wait(P& pool, WorkFirstTask<U, P> task);
+
+public:
+    /**
+     * @brief Take ownership of a coroutine frame (used by the promise).
+     */
+    explicit WorkFirstTask(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+    WorkFirstTask(WorkFirstTask&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+
+    WorkFirstTask& operator =(WorkFirstTask&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Disable copy construction.
+     */
+    WorkFirstTask(const WorkFirstTask&) = delete;
+
+    /**
+     * @brief Disable copy assignment.
+     */
+    WorkFirstTask& operator =(const WorkFirstTask&) = delete;
+
+    /**
+     * @brief Destroy the coroutine frame.
+     */
+    ~WorkFirstTask() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    /**
+     * @brief Retrieve the result of a completed task.
+     *
+     * Only valid after the task completed, i.e. after awaiting it directly or
+     * after the `join()` following its spawn. Rethrows an exception escaping the
+     * task body.
+     *
+     * @return The value passed to `co_return`.
+     */
+    T get() {
+        return handle_.promise().take();
+    }
+
+    /**
+     * @brief Awaiter running the task serially, as an ordinary call.
+     */
+    struct CallAwaiter {
+        std::coroutine_handle<promise_type> child;
+
+        bool await_ready() const noexcept { return false; }
+
+        template <class Promise>
+        void await_suspend(std::coroutine_handle<Promise> parent) noexcept {
+            child.promise().mode_ = WorkFirstPromiseBase<Pool>::Mode::called;
+            child.promise().parent_ = parent;
+            Pool::transfer_to(child);
+        }
+
+        T await_resume() { return child.promise().take(); }
+    };
+
+    /**
+     * @brief Run the task to completion before continuing (`co_await task`).
+     */
+    CallAwaiter operator co_await() & noexcept { return CallAwaiter{handle_}; }
+};
+
+template <class T, class Pool>
+inline WorkFirstTask<T, Pool> WorkFirstPromise<T, Pool>::get_return_object() noexcept {
+    return WorkFirstTask<T, Pool>(std::coroutine_handle<WorkFirstPromise<T, Pool>>::from_promise(*this));
+}
+
+template <class Pool>
+inline WorkFirstTask<void, Pool> WorkFirstPromise<void, Pool>::get_return_object() noexcept {
+    return WorkFirstTask<void, Pool>(std::coroutine_handle<WorkFirstPromise<void, Pool>>::from_promise(*this));
+}
+
+/**
+ * @brief Awaiter implementing work-first spawn.
+ *
+ * Publishes the awaiting coroutine's continuation and transfers control to the
+ * child. Outside a worker of a `Pool` there is nobody to steal from, so the
+ * child simply runs as a call.
+ */
+template <class U, class Pool>
+class WorkFirstSpawnAwaiter {
+private:
+    /**
+     * @brief Child to start.
+     */
+    std::coroutine_handle<WorkFirstPromise<U, Pool>> child_;
+
+public:
+    explicit WorkFirstSpawnAwaiter(WorkFirstTask<U, Pool>& child) noexcept : child_(child.handle_) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    template <class Promise>
+    void await_suspend(std::coroutine_handle<Promise> parent) {
+        // The awaiter lives in the parent's frame, which a thief may resume (and
+        // advance past this awaiter) as soon as the continuation is published.
+        std::coroutine_handle<WorkFirstPromise<U, Pool>> child = child_;
+        WorkFirstPromiseBase<Pool>& child_promise = child.promise();
+        child_promise.parent_ = parent;
+
+        Pool* pool = Pool::current();
+        if (pool == nullptr) {
+            child_promise.mode_ = WorkFirstPromiseBase<Pool>::Mode::called;
+            Pool::transfer_to(child);
+            return;
+        }
+
+        child_promise.mode_ = WorkFirstPromiseBase<Pool>::Mode::spawned;
+        child_promise.parent_promise_ = &parent.promise();
+        parent.promise().join_count_.fetch_add(1, std::memory_order_relaxed);
+        pool->push_continuation(parent);
+        Pool::transfer_to(child);
+    }
+
+    void await_resume() const noexcept {}
+};
+
+/**
+ * @brief Spawn a child work-first: run it now and make the caller's continuation stealable.
+ *
+ * The child's result is available through `child.get()` after `co_await join()`.
+ *
+ * @param child Task to run; must outlive the matching `join()`.
+ * @return Awaiter to `co_await` from inside a `WorkFirstTask` coroutine.
+ */
+template <class U, class Pool>
+WorkFirstSpawnAwaiter<U, Pool> spawn(WorkFirstTask<U, Pool>& child) noexcept {
+    return WorkFirstSpawnAwaiter<U, Pool>(child);
+}
+
+/**
+ * @brief Awaiter implementing `join()`.
+ */
+class WorkFirstJoinAwaiter {
+private:
+    /**
+     * @brief Join count of the awaiting coroutine, captured in `await_suspend`.
+     */
+    std::atomic<int>* join_count_ = nullptr;
+
+public:
+    bool await_ready() const noexcept { return false; }
+
+    template <class Promise>
+    bool await_suspend(std::coroutine_handle<Promise> self) noexcept {
+        join_count_ = &self.promise().join_count_;
+        // Drop our own unit; if children are still running the last one resumes us.
+        // No frame access after the decrement unless we continue ourselves.
+        if (join_count_->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            join_count_->store(1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    void await_resume() noexcept {
+        join_count_->store(1, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief Wait for every child spawned by the current coroutine.
+ *
+ * The code after the join may run on a different worker than the code before it.
+ *
+ * @return Awaiter to `co_await` from inside a `WorkFirstTask` coroutine.
+ */
+inline WorkFirstJoinAwaiter join() noexcept {
+    return {};
+}
+
+/**
+ * @brief Run a root work-first task on the pool and block until it completes.
+ *
+ * Must be called from a thread that is not a worker of @p pool, since the caller
+ * blocks for the whole computation.
+ *
+ * @param pool Pool whose workers execute (and steal from) the task tree; of
+ *        the variant the task was declared for.
+ * @param task Root task; consumed.
+ * @return The root task's result. Exceptions escaping the root are rethrown.
+ */
+template <class T, class Pool>
+T sync_wait(Pool& pool, WorkFirstTask<T, Pool> task) {
+    WorkFirstRootSignal signal;
+    auto handle = task.handle_;
+    handle.promise().mode_ = WorkFirstPromiseBase<Pool>::Mode::root;
+    handle.promise().root_signal_ = &signal;
+
+    pool.submit([handle] { Pool::run_continuation(handle); });
+
+    std::unique_lock<std::mutex> lock(signal.mut);
+    signal.cv.wait(lock, [&signal] { return signal.done; });
+    return task.get();
+}
+
+#endif // __WORK_FIRST_HPP__
@@ -0,0 +1,214 @@
+#ifndef __WORKER_LOCAL_HPP__
+#define __WORKER_LOCAL_HPP__
+
+#include <atomic>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "thread_pool.hpp"
+
+/**
+ * @file worker_local.hpp
+ * @brief Per-worker storage with a merge step (enumerable thread-specific storage).
+ *
+ * Tasks that all update one shared accumulator (an atomic counter, a histogram)
+ * serialize on its cache line. `WorkerLocal<T>` gives every worker of a pool its
+ * own cache-line-aligned copy of `T`, indexed by `ThreadPool::current_worker_index()`,
+ * so a task updates its worker's slot with plain loads and stores. After the
+ * parallel phase, `combine` or `for_each` merges the slots.
+ *
+ * @details
+ * - Threads that are not workers of the pool (e.g. the caller of `heartbeat_for`,
+ *   which runs iterations itself) all share one extra slot. Plain `T` is only
+ *   safe there if a single outside thread uses it at a time; `ShardedCounter`
+ *   handles this by using an atomic read-modify-write on the shared slot only.
+ *
+ * @author dssregi
+ * @version 1.0
+ * @date 2025-11-14
+ */
+
+/**
+ * @brief One instance of `T` per pool worker plus one shared by outside threads.
+ *
+ * @tparam T Slot type; default-constructible or constructible from the
+ *           arguments passed to the constructor.
+ *
+ * @thread_safety Each worker may freely use its own slot. Merging (`combine`,
+ *                `for_each`) must not race with writers unless `T` is atomic.
+ */
+template <class T>
+class WorkerLocal {
+private:
+    /**
+     * @brief Slot padded to its own cache line(s).
+     */
+    struct alignas(64) Slot {
+        T value;
+
+        template <class... Args>
+        explicit Slot(const Args&... args) : value(args...) {}
+    };
+
+    /**
+     * @brief Pool whose workers index the slots.
+     */
+    const ThreadPool& pool_;
+
+    /**
+     * @brief Number of slots: one per worker plus the shared outside slot.
+     */
+    const int count_;
+
+    /**
+     * @brief Slot storage (over-aligned allocation).
+     */
+    Slot* slots_;
+
+public:
+    /**
+     * @brief Create one slot per worker of @p pool plus the outside slot.
+     *
+     * @param pool Pool whose workers will use the slots.
+     * @param args Arguments every slot's `T` is constructed from.
+     */
+    template <class... Args>
+    explicit WorkerLocal(const ThreadPool& pool, const Args&... args)
+        : pool_(pool), count_(pool.size() + 1),
+          slots_(static_cast<Slot*>(::operator new(sizeof(Slot) * count_, std::align_val_t{alignof(Slot)}))) {
+        for (int i = 0; i < count_; ++i) {
+            new (&slots_[i]) Slot(args...);
+        }
+    }
+
+    ~WorkerLocal() {
+        for (int i = 0; i < count_; ++i) {
+            slots_[i].~Slot();
+        }
+        ::operator delete(slots_, std::align_val_t{alignof(Slot)});
+    }
+
+    /**
+     * @brief Disable copy construction.
+     */
+    WorkerLocal(const WorkerLocal&) = delete;
+
+    /**
+     * @brief Disable copy assignment.
+     */
+    WorkerLocal& operator =(const WorkerLocal&) = delete;
+
+    /**
+     * @brief Index of the calling thread's slot.
+     *
+     * @return The worker index for workers of the pool, `size() - 1` otherwise.
+     */
+    int slot_index() const {
+        return ThreadPool::current() == &pool_ ? ThreadPool::current_worker_index() : count_ - 1;
+    }
+
+    /**
+     * @brief Whether the calling thread maps to the slot shared by outside threads.
+     */
+    bool local_is_shared() const {
+        return slot_index() == count_ - 1;
+    }
+
+    /**
+     * @brief The calling thread's slot.
+     */
+    T& local() {
+        return slots_[slot_index()].value;
+    }
+
+    /**
+     * @brief Number of slots (pool size + 1).
+     */
+    int size() const {
+        return count_;
+    }
+
+    /**
+     * @brief Fold all slots with @p op, starting from the first slot.
+     *
+     * @param op Binary operation `T op(const T&, const T&)`.
+     * @return The combined value.
+     */
+    template <class Op>
+    T combine(Op op) const {
+        T result = slots_[0].value;
+        for (int i = 1; i < count_; ++i) {
+            result = op(result, slots_[i].value);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Call @p func on every slot, in slot order.
+     */
+    template <class F>
+    void for_each(F func) {
+        for (int i = 0; i < count_; ++i) {
+            func(slots_[i].value);
+        }
+    }
+
+    /**
+     * @brief Call @p func on every slot, in slot order (read-only).
+     */
+    template <class F>
+    void for_each(F func) const {
+        for (int i = 0; i < count_; ++i) {
+            func(static_cast<const T&>(slots_[i].value));
+        }
+    }
+};
+
+/**
+ * @brief Counter sharded over a pool's workers.
+ *
+ * `add` is a load and a release store on the worker's own slot (no locked
+ * read-modify-write); only outside threads, which share a slot, pay for an
+ * atomic `fetch_add`. `sum` may be polled while workers are still adding; its
+ * acquire loads make everything a worker wrote before an `add` visible to a
+ * thread that observes that add in the total, so it can signal completion.
+ */
+class ShardedCounter {
+private:
+    /**
+     * @brief Per-worker partial counts.
+     */
+    WorkerLocal<std::atomic<long>> shards_;
+
+public:
+    /**
+     * @brief Create a zeroed counter for the workers of @p pool.
+     */
+    explicit ShardedCounter(const ThreadPool& pool) : shards_(pool, 0L) {}
+
+    /**
+     * @brief Add @p n to the calling thread's shard.
+     */
+    void add(long n = 1) {
+        std::atomic<long>& shard = shards_.local();
+        if (shards_.local_is_shared()) {
+            shard.fetch_add(n, std::memory_order_release);
+        } else {
+            shard.store(shard.load(std::memory_order_relaxed) + n, std::memory_order_release);
+        }
+    }
+
+    /**
+     * @brief Current total over all shards (a snapshot while adds are in progress).
+     */
+    long sum() const {
+        long total = 0;
+        shards_.for_each([&total](const std::atomic<long>& shard) {
+            total += shard.load(std::memory_order_acquire);
+        });
+        return total;
+    }
+};
+
+#endif // __WORKER_LOCAL_HPP__
@@ -0,0 +1,148 @@
+#ifndef __WORKER_OPTIONS_HPP__
+#define __WORKER_OPTIONS_HPP__
+
+#include <cerrno>
+#include <optional>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/**
+ * @file worker_options.hpp
+ * @brief Operating-system placement of a pool's worker threads.
+ *
+ * Latency-critical pools want their workers pinned to isolated cores and,
+ * possibly, under a real-time scheduling class; batch pools want the opposite,
+ * so that they only soak up cycles nobody else needs. These are run-time
+ * choices (core lists and privileges differ per machine), so they are passed
+ * to the pool's constructor rather than being compile-time policies; whether
+ * idle workers park or busy-poll is the `IdlePolicy`'s business (`BusyPoll`).
+ *
+ * @details
+ * - Every worker applies the options to itself when it starts. Failures do not
+ *   stop the pool: the worker keeps its inherited settings and the first error
+ *   is available from `ThreadPool::worker_options_error()`.
+ * - `SCHED_FIFO` and `SCHED_RR` need `CAP_SYS_NICE` (or an `RLIMIT_RTPRIO`
+ *   allowance); lowering the nice value needs the same.
+ * - Never combine a real-time class with `BusyPoll` on cores that are not
+ *   isolated: the pollers never block, so other threads on those cores only
+ *   run when the kernel's real-time throttling steps in.
+ *
+ * @author dssregi
+ * @version 1.0
+ * @date 2025-11-14
+ */
+
+/**
+ * @brief Kernel scheduling class of the worker threads.
+ */
+enum class SchedClass {
+    inherit,        ///< Keep the creating thread's class.
+    other,          ///< `SCHED_OTHER`: normal time sharing.
+    batch,          ///< `SCHED_BATCH`: CPU-bound, tolerates higher wake-up latency.
+    idle,           ///< `SCHED_IDLE`: runs only when the CPU is otherwise idle.
+    fifo,           ///< `SCHED_FIFO`: real time, runs until it blocks or yields.
+    round_robin     ///< `SCHED_RR`: real time with a time slice.
+};
+
+/**
+ * @brief Name of a scheduling class, for reports.
+ */
+inline const char* to_string(SchedClass sched_class) {
+    switch (sched_class) {
+        case SchedClass::inherit: return "inherit";
+        case SchedClass::other: return "SCHED_OTHER";
+        case SchedClass::batch: return "SCHED_BATCH";
+        case SchedClass::idle: return "SCHED_IDLE";
+        case SchedClass::fifo: return "SCHED_FIFO";
+        case SchedClass::round_robin: return "SCHED_RR";
+    }
+    return "?";
+}
+
+/**
+ * @brief Thread count, CPU placement and scheduling class of a pool's workers.
+ *
+ * Every member has a default member initialiser, so designated initialisers
+ * may name any subset (`WorkerOptions{.threads = 1}`) without tripping
+ * `-Wmissing-field-initializers`.
+ */
+struct WorkerOptions {
+    /**
+     * @brief Number of workers; 0 means one per entry of `cpus`, or one per
+     *        hardware thread if `cpus` is empty.
+     */
+    int threads = 0;
+
+    /**
+     * @brief CPUs to pin to: worker i runs on `cpus[i % cpus.size()]`. Empty
+     *        leaves the affinity alone.
+     */
+    std::vector<int> cpus{};
+
+    /**
+     * @brief Scheduling class of every worker.
+     */
+    SchedClass sched_class = SchedClass::inherit;
+
+    /**
+     * @brief Static priority for `fifo` and `round_robin` (1-99); ignored otherwise.
+     */
+    int rt_priority = 1;
+
+    /**
+     * @brief Nice value for `other` and `batch` workers (-20 to 19); unset keeps it.
+     */
+    std::optional<int> nice{};
+};
+
+/**
+ * @brief Apply @p options to the calling thread, worker @p worker of its pool.
+ *
+ * Every setting is attempted even if an earlier one fails.
+ *
+ * @return 0 on success, otherwise the errno of the first setting that failed.
+ */
+inline int apply_worker_options(const WorkerOptions& options, int worker) {
+    int error = 0;
+    auto note = [&error](int rc) {
+        if (rc != 0 && error == 0) {
+            error = rc;
+        }
+    };
+
+    if (!options.cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(options.cpus[static_cast<size_t>(worker) % options.cpus.size()], &set);
+        note(::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set));
+    }
+
+    int policy = -1;
+    switch (options.sched_class) {
+        case SchedClass::inherit: break;
+        case SchedClass::other: policy = SCHED_OTHER; break;
+        case SchedClass::batch: policy = SCHED_BATCH; break;
+        case SchedClass::idle: policy = SCHED_IDLE; break;
+        case SchedClass::fifo: policy = SCHED_FIFO; break;
+        case SchedClass::round_robin: policy = SCHED_RR; break;
+    }
+    if (policy >= 0) {
+        sched_param param{};
+        param.sched_priority = (policy == SCHED_FIFO || policy == SCHED_RR) ? options.rt_priority : 0;
+        note(::pthread_setschedparam(::pthread_self(), policy, &param));
+    }
+
+    // Nice values are per thread on Linux, addressed by thread id
+    if (options.nice) {
+        const id_t tid = static_cast<id_t>(::syscall(SYS_gettid));
+        note(::setpriority(PRIO_PROCESS, tid, *options.nice) == 0 ? 0 : errno);
+    }
+    return error;
+}
+
+#endif // __WORKER_OPTIONS_HPP__
@@ -0,0 +1,195 @@
+/**
+ * @file wsp_top.cpp
+ * @brief Live per-worker view of a pool that publishes its statistics.
+ *
+ * Attaches read-only to the shared-memory segment written by
+ * `ThreadPool::publish_stats` and redraws a table once per interval:
+ *
+ * @code
+ * g++ -std=c++20 -O2 src/tools/wsp_top.cpp -o wsp-top
+ * ./wsp-top /wsp-demo -i 500
+ * @endcode
+ *
+ * @details
+ * - Rates are computed from the difference between two snapshots, so the
+ *   first table appears after one interval.
+ * - `load` is the share of wall time the worker was not parked, i.e. running
+ *   tasks or looking for work; `steal ok` is the share of steal attempts that
+ *   found a task; `queued` is the current depth of the worker's queues;
+ *   `long` counts tasks over the pool's watchdog threshold (`enable_watchdog`).
+ * - The tool exits when the publishing process is gone, after `-n` tables, or
+ *   on Ctrl-C. It never writes to the segment, so it cannot disturb the pool.
+ *
+ * @author dssregi
+ * @version 1.0
+ * @date 2025-11-14
+ */
+
+#include "../core/pool_stats.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <signal.h>
+#include <unistd.h>
+
+/**
+ * @brief Command-line options.
+ */
+struct TopOptions {
+    std::string segment = "/wsp-demo";   ///< Shared-memory object to attach to.
+    int interval_ms = 1000;              ///< Refresh interval.
+    long iterations = -1;                ///< Tables to print; negative for unlimited.
+};
+
+/**
+ * @brief Print usage to stderr.
+ */
+static void usage(const char* argv0) {
+    std::cerr << "usage: " << argv0 << " [segment] [-i interval_ms] [-n iterations]\n"
+              << "  segment     shared-memory name given to publish_stats (default /wsp-demo)\n";
+}
+
+/**
+ * @brief Parse the command line; exits on malformed arguments.
+ */
+static TopOptions parse_options(int argc, char** argv) {
+    TopOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if ((arg == "-i" || arg == "-n") && i + 1 < argc) {
+            const long value = std::strtol(argv[++i], nullptr, 10);
+            if (value <= 0) {
+                usage(argv[0]);
+                std::exit(2);
+            }
+            if (arg == "-i") {
+                options.interval_ms = static_cast<int>(value);
+            } else {
+                options.iterations = value;
+            }
+        } else if (arg == "-h" || arg == "--help") {
+            usage(argv[0]);
+            std::exit(0);
+        } else if (!arg.empty() && arg[0] != '-') {
+            options.segment = arg[0] == '/' ? arg : "/" + arg;
+        } else {
+            usage(argv[0]);
+            std::exit(2);
+        }
+    }
+    return options;
+}
+
+/**
+ * @brief Whether the publishing process still exists.
+ */
+static bool publisher_alive(int pid) {
+    return pid > 0 && (::kill(pid, 0) == 0 || errno == EPERM);
+}
+
+/**
+ * @brief Rate per second of a counter that advanced by @p delta over @p seconds.
+ */
+static double per_second(uint64_t delta, double seconds) {
+    return seconds > 0.0 ? static_cast<double>(delta) / seconds : 0.0;
+}
+
+/**
+ * @brief Difference of two counter readings, zero if the counter went backwards
+ *        (it is racy while a worker is parking).
+ */
+static uint64_t advance(uint64_t now, uint64_t before) {
+    return now > before ? now - before : 0;
+}
+
+/**
+ * @brief Print one table comparing snapshot @p now with @p before.
+ */
+static void print_table(const TopOptions& options, const PoolStatsSnapshot& before, const PoolStatsSnapshot& now,
+                        bool clear) {
+    const double seconds = static_cast<double>(advance(now.published_ns, before.published_ns)) * 1e-9;
+    const double age_ms = static_cast<double>(advance(monotonic_ns(), now.published_ns)) * 1e-6;
+
+    if (clear) {
+        std::printf("\033[H\033[2J");
+    }
+    std::printf("wsp-top  %s  pid %d  %zu workers  snapshot #%llu, %.0f ms old\n\n", options.segment.c_str(),
+                now.pid, now.workers.size(), static_cast<unsigned long long>(now.snapshots), age_ms);
+    std::printf("%6s %7s %6s %10s %10s %9s %7s %6s\n", "worker", "state", "load", "tasks/s", "steals/s", "steal ok",
+                "queued", "long");
+
+    double total_tasks = 0.0;
+    double total_steals = 0.0;
+    uint64_t total_queued = 0;
+    uint64_t total_long = 0;
+    for (size_t w = 0; w < now.workers.size(); ++w) {
+        const WorkerStatsSnapshot& a = before.workers[w];
+        const WorkerStatsSnapshot& b = now.workers[w];
+
+        const double parked = static_cast<double>(advance(b.parked_ns, a.parked_ns)) * 1e-9;
+        const double load = seconds > 0.0 ? 100.0 * std::max(0.0, 1.0 - parked / seconds) : 0.0;
+        const uint64_t steals = advance(b.steals, a.steals);
+        const uint64_t attempts = steals + advance(b.failed_steals, a.failed_steals);
+        const double tasks_rate = per_second(advance(b.tasks, a.tasks), seconds);
+        const double steals_rate = per_second(steals, seconds);
+
+        char steal_ok[16] = "-";
+        if (attempts > 0) {
+            std::snprintf(steal_ok, sizeof(steal_ok), "%.1f%%", 100.0 * static_cast<double>(steals) / attempts);
+        }
+        std::printf("%6zu %7s %5.1f%% %10.0f %10.0f %9s %7llu %6llu\n", w, b.parked ? "parked" : "active", load,
+                    tasks_rate, steals_rate, steal_ok, static_cast<unsigned long long>(b.queued),
+                    static_cast<unsigned long long>(b.long_tasks));
+
+        total_tasks += tasks_rate;
+        total_steals += steals_rate;
+        total_queued += b.queued;
+        total_long += b.long_tasks;
+    }
+    std::printf("%6s %7s %6s %10.0f %10.0f %9s %7llu %6llu\n", "all", "", "", total_tasks, total_steals, "",
+                static_cast<unsigned long long>(total_queued), static_cast<unsigned long long>(total_long));
+    std::fflush(stdout);
+}
+
+/**
+ * @brief Attach to the segment and print tables until the publisher exits.
+ *
+ * @return 0 when the publisher exited or the iterations were printed, 1 if the
+ *         segment could not be opened.
+ */
+int main(int argc, char** argv) {
+    const TopOptions options = parse_options(argc, argv);
+
+    try {
+        StatsReader reader(options.segment);
+        const bool clear = ::isatty(STDOUT_FILENO);
+
+        PoolStatsSnapshot before = reader.snapshot();
+        for (long printed = 0; options.iterations < 0 || printed < options.iterations; ++printed) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(options.interval_ms));
+            PoolStatsSnapshot now = reader.snapshot();
+            if (!publisher_alive(now.pid)) {
+                std::printf("publisher %d exited\n", now.pid);
+                return 0;
+            }
+            if (now.snapshots == before.snapshots) {
+                // Nothing new was published: avoid printing a table of zero rates
+                --printed;
+                continue;
+            }
+            print_table(options, before, now, clear);
+            before = std::move(now);
+        }
+    } catch (const std::system_error& e) {
+        std::cerr << "wsp-top: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}